@@ -0,0 +1,8 @@
+#version 330
+
+// Depth-only pass used when rendering shadow maps.
+// The shadow map framebuffer has no colour attachment,
+// so nothing is written here; depth is written by the fixed pipeline.
+
+void main() {
+}
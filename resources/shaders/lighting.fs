@@ -1,9 +1,10 @@
 #version 330
 
 // NOTES:
-//  POINT lights are lit but NOT shadowed here (visibility = 1.0).
-//  Some of this shader is patched by the main program.
-//  This means that the shader will not work by itself.
+//  Directional lights are looped over for every fragment and can be shadowed.
+//  POINT lights are only shaded per cluster and are NOT shadowed.
+//  MAX_LIGHTS, MAX_SHADOW_SLOTS and CLUSTER_INDEX_WIDTH are prepended by global::loadShader(),
+//  the defaults below are only used if the shader is loaded by itself.
 
 // Inputs from the vertex shader
 in vec3 fragPosition;
@@ -15,28 +16,41 @@ in vec3 fragNormal;
 uniform sampler2D texture0;   // base texture (bind a 1x1 white if untextured)
 uniform vec4 colDiffuse;      // material tint
 
-// Patched at runtime
-#define MAX_LIGHTS x
-#define LIGHT_DIRECTIONAL 0
-#define LIGHT_POINT       1
-
-struct Light {
-    int  enabled;
-    int  type;
-    vec3 position;
-    vec3 target;
-    vec4 color;   // rgb in 0..1
-};
-
-uniform Light lights[MAX_LIGHTS];
+#ifndef MAX_LIGHTS
+#define MAX_LIGHTS 16
+#endif
+#ifndef MAX_SHADOW_SLOTS
+#define MAX_SHADOW_SLOTS 16
+#endif
+#ifndef CLUSTER_INDEX_WIDTH
+#define CLUSTER_INDEX_WIDTH 1024
+#endif
+
+// Light buffer, see LightManager.hpp. One row per light, 3 texels:
+//  0: position, radius
+//  1: direction, enabled
+//  2: colour (rgb in 0..1, times intensity), shadow slot (-1 if not shadowed)
+// Rows [0, lightCount) are directional lights, point lights start at MAX_LIGHTS.
+uniform sampler2D lightData;
+uniform int   lightCount;
 uniform vec4  ambient;
 uniform vec3  viewPos;   // camera position (world)
 
-// Shadow maps + matrix (and texel size) per light
-// shadowMap and lightVP are patched in global::loadAndPatchShader()
-uniform sampler2D shadowMap;
-uniform mat4 lightVP;
-uniform int shadowMapResolution; // Side length (pixels)
+// All shadow maps live in one depth texture split into square tiles.
+// lightVP is indexed by the tile (slot), not by the light.
+uniform sampler2D shadowAtlas;
+uniform mat4 lightVP[MAX_SHADOW_SLOTS];
+uniform int shadowAtlasTiles;    // tiles per side
+uniform int shadowMapResolution; // Side length of one tile (pixels)
+
+// Clustered point lights, see ClusteredLighting.hpp
+uniform sampler2D clusterData;    // 1 texel per cluster: (offset, count)
+uniform sampler2D clusterIndices; // lightData rows, CLUSTER_INDEX_WIDTH per row
+uniform ivec3 clusterDims;
+uniform vec2  screenSize;
+uniform vec3  viewDir;           // camera forward (world)
+uniform float clusterNear;
+uniform float clusterScale;      // slices / log(far / near)
 
 // Output
 out vec4 finalColor;
@@ -46,14 +60,19 @@ const float BIAS_BASE = 0.0002;  // slope-scale factor
 const float BIAS_MIN  = 0.00002; // minimum bias
 const float BIAS_EPS  = 0.00001; // small constant to reduce acne further
 
-float SampleShadowMap(int i, vec2 uv) {
-    //patched in global::loadAndPatchShader()
-GetShadowMapFunction
+float SampleShadowMap(int slot, vec2 uv) {
+    // uv is in the light's own 0..1 range, clamp it so PCF never reads a neighbouring tile
+    float halfTexel = 0.5 / float(shadowMapResolution);
+    vec2 tileUV = clamp(uv, vec2(halfTexel), vec2(1.0 - halfTexel));
+    vec2 tile = vec2(slot % shadowAtlasTiles, slot / shadowAtlasTiles);
+    return texture(shadowAtlas, (tile + tileUV) / float(shadowAtlasTiles)).r;
 }
 
-mat4 getLightVP(int i) {
-    //patched in global::loadAndPatchShader()
-GetLightVPFunction
+ivec3 GetCluster() {
+    vec2 tile = gl_FragCoord.xy / screenSize * vec2(clusterDims.xy);
+    float depth = dot(fragPosition - viewPos, viewDir);
+    int slice = (depth <= clusterNear) ? 0 : int(log(depth / clusterNear) * clusterScale);
+    return clamp(ivec3(ivec2(tile), slice), ivec3(0), clusterDims - 1);
 }
 
 void main() {
@@ -66,21 +85,14 @@ void main() {
     // Accumulator for per-light contributions
     vec3 accum = vec3(0.0);
 
-    // Per-light loop
-    for (int i = 0; i < MAX_LIGHTS; ++i) {
-        if (lights[i].enabled == 0) continue;
+    // Directional light loop
+    for (int i = 0; i < lightCount; ++i) {
+        vec4 dirEnabled = texelFetch(lightData, ivec2(1, i), 0);
+        if (dirEnabled.w == 0.0) continue;
 
         // Compute light direction at the fragment (unit vector pointing FROM fragment TOWARDS light)
-        vec3 L;
-        bool isDirectional = (lights[i].type == LIGHT_DIRECTIONAL);
-        if (isDirectional) {
-            // Example semantics: l = -lightDir, where lightDir = (target - position)
-            vec3 lightDir = normalize(lights[i].target - lights[i].position);
-            L = -lightDir;
-        } else {
-            // Point light: from fragment towards light position
-            L = normalize(lights[i].position - fragPosition);
-        }
+        // Example semantics: l = -lightDir, where lightDir = (target - position)
+        vec3 L = -dirEnabled.xyz;
 
         float NdotL = max(dot(N, L), 0.0);
         if (NdotL <= 0.0) continue;
@@ -91,15 +103,17 @@ void main() {
 
         // Per-light lit color before shadowing
         // finalColor_light = texelColor * ((colDiffuse*fragColor + spec) * (lightColor*NdotL))
-        vec3 lightColor = lights[i].color.rgb;
+        vec4 colorSlot  = texelFetch(lightData, ivec2(2, i), 0);
+        vec3 lightColor = colorSlot.rgb;
         vec3 perLight   = (texelColor.rgb) * ((tint.rgb + vec3(spec)) * (lightColor * NdotL));
 
         // Shadow factor
         float visibility = 1.0;
 
-        if (isDirectional) {
+        int slot = int(colorSlot.w);
+        if (slot >= 0) {
             // Project fragment into light space -> NDC -> [0,1]
-            vec4 fragLS = getLightVP(i) * vec4(fragPosition, 1.0);
+            vec4 fragLS = lightVP[slot] * vec4(fragPosition, 1.0);
 
             fragLS.xyz /= fragLS.w;
             vec3 uvz    = fragLS.xyz * 0.5 + 0.5;
@@ -119,7 +133,7 @@ void main() {
                 vec2 texelSize = vec2(1.0 / float(shadowMapResolution));
                 for (int sx = -1; sx <= 1; ++sx) {
                     for (int sy = -1; sy <= 1; ++sy) {
-                        float sampleDepth = SampleShadowMap(i, uvz.xy + texelSize * vec2(sx, sy));
+                        float sampleDepth = SampleShadowMap(slot, uvz.xy + texelSize * vec2(sx, sy));
                         if (uvz.z - bias > sampleDepth) occluded++;
                     }
                 }
@@ -134,6 +148,35 @@ void main() {
         accum += perLight * visibility;
     }
 
+    // Point lights of this fragment's cluster only
+    ivec3 cluster = GetCluster();
+    vec4 clusterInfo = texelFetch(clusterData, ivec2(cluster.x + cluster.y * clusterDims.x, cluster.z), 0);
+    int offset = int(clusterInfo.x);
+    int count  = int(clusterInfo.y);
+    for (int j = 0; j < count; ++j) {
+        int index = offset + j;
+        int li = int(texelFetch(clusterIndices, ivec2(index % CLUSTER_INDEX_WIDTH, index / CLUSTER_INDEX_WIDTH), 0).r);
+        vec4 posRadius  = texelFetch(lightData, ivec2(0, li), 0);
+        vec3 lightColor = texelFetch(lightData, ivec2(2, li), 0).rgb;
+
+        vec3 toLight = posRadius.xyz - fragPosition;
+        float dist2  = dot(toLight, toLight);
+        float range2 = posRadius.w * posRadius.w;
+        if (dist2 >= range2) continue;
+
+        vec3 L = toLight * inversesqrt(dist2);
+        float NdotL = max(dot(N, L), 0.0);
+        if (NdotL <= 0.0) continue;
+
+        // Smooth falloff to exactly 0 at the light's radius
+        float falloff = 1.0 - dist2 / range2;
+        falloff *= falloff;
+
+        vec3 R = reflect(-L, N);
+        float spec = pow(max(dot(V, R), 0.0), 16.0);
+        accum += (texelColor.rgb) * ((tint.rgb + vec3(spec)) * (lightColor * NdotL * falloff));
+    }
+
     // Ambient add
     vec3 ambientTerm = (texelColor.rgb * (ambient.rgb)) * tint.rgb;
 
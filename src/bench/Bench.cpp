@@ -0,0 +1,53 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <chrono>
+#include <raylib.h>
+
+struct BenchEntry {
+    const char* name;
+    int (*function)(const bench::BenchArgs& args);
+    const char* usage;
+};
+
+static const BenchEntry BENCHMARKS[] = {
+    {"pathfinding", bench::pathfinding, "[map size = 1024] [paths = 2000] [edits = 64]"},
+    {"entities", bench::entities, "[entities = 100000] [ticks = 300]"},
+    {"vehicles", bench::vehicles, "[ticks = 300] [map size = 512] [threads = cores]"},
+    {"network", bench::network, "[map size = 1024] [edits = 20000] [queries = 200000]"},
+    {"economy", bench::economy, "[years = 10] [industries = 20000] [towns = 2000] [threads = cores]"},
+    {"chunks", bench::chunks, "[map size = 512] [repeats = 3]"},
+    {"spatial", bench::spatial, "[props = 100000] [frames = 200]"},
+    {"regression", bench::regression, "[update] [tolerance % = 50]"},
+    {"occlusion", bench::occlusion, "[map size = 256] [views = 100]"},
+};
+
+int bench::run(const std::string& name, const BenchArgs& args) {
+    for (const BenchEntry& entry : BENCHMARKS) {
+        if (name == entry.name) return entry.function(args);
+    }
+
+    TraceLog(LOG_WARNING, "[Bench] unknown benchmark '%s', available:", name.c_str());
+    for (const BenchEntry& entry : BENCHMARKS) {
+        TraceLog(LOG_WARNING, "[Bench]   --bench %s %s", entry.name, entry.usage);
+    }
+    return 1;
+}
+
+double bench::now() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+int bench::getIntArg(const BenchArgs& args, const size_t index, const int fallback) {
+    if (index >= args.size()) return fallback;
+    try {
+        return std::stoi(args[index]);
+    } catch (const std::exception&) {
+        TraceLog(LOG_WARNING, "[Bench] '%s' is not a number, using %i", args[index].c_str(), fallback);
+        return fallback;
+    }
+}
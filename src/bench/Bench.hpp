@@ -0,0 +1,34 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_BENCH_HPP
+#define BUSINESS_GAME_BENCH_HPP
+#include <string>
+#include <vector>
+
+// Headless benchmarks, run with `business_game --bench <name> [args...]`.
+// They don't open a window and report through TraceLog. The exit code is 0 on success.
+namespace bench {
+    using BenchArgs = std::vector<std::string>;
+
+    // Runs the benchmark called name, lists them all if there is no such benchmark
+    int run(const std::string& name, const BenchArgs& args);
+
+    // Helpers
+    double now(); // seconds, monotonic
+    int getIntArg(const BenchArgs& args, size_t index, int fallback);
+
+    // Benchmarks, one per file
+    int pathfinding(const BenchArgs& args);
+    int entities(const BenchArgs& args);
+    int vehicles(const BenchArgs& args);
+    int network(const BenchArgs& args);
+    int economy(const BenchArgs& args);
+    int chunks(const BenchArgs& args);
+    int spatial(const BenchArgs& args);
+    int regression(const BenchArgs& args);
+    int occlusion(const BenchArgs& args);
+}
+
+#endif //BUSINESS_GAME_BENCH_HPP
@@ -0,0 +1,226 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <raylib.h>
+#include <raymath.h>
+#include "voxel/VoxelMesher.hpp"
+
+static const std::pair<ChunkMesher, const char*> MESHERS[] = {
+    {ChunkMesher::Naive, "naive"},
+    {ChunkMesher::Binary, "binary"},
+    {ChunkMesher::Greedy, "greedy"},
+};
+
+// Every voxel face covered by the meshes (made with origin 0 and voxelSize 1), as material | face | voxel.
+// False if a quad faces away from its normal.
+template<int N>
+static bool getCoveredFaces(const std::vector<MaterialMesh>& meshes, std::vector<uint64_t>& faces) {
+    faces.clear();
+    for (const MaterialMesh& mat : meshes) {
+        for (int q = 0; q < mat.mesh.vertexCount / 4; q++) {
+            // World (X=x, Y=z_map, Z=y) -> Map
+            Vector3 corners[4];
+            for (int i = 0; i < 4; i++) {
+                const float* v = mat.mesh.vertices + (q * 4 + i) * 3;
+                corners[i] = Vector3{v[0], v[2], v[1]};
+            }
+            const float* n = mat.mesh.normals + q * 4 * 3;
+            const Vector3 normal = {n[0], n[2], n[1]};
+            // Map space is mirrored (y and z swapped), so the winding is the other way around in it
+            const Vector3 cross = Vector3CrossProduct(Vector3Subtract(corners[1], corners[0]), Vector3Subtract(corners[2], corners[0]));
+            if (Vector3DotProduct(cross, normal) >= 0.0f) return false;
+
+            Vector3 lo = corners[0], hi = corners[0];
+            for (const Vector3& c : corners) {
+                lo = Vector3Min(lo, c);
+                hi = Vector3Max(hi, c);
+            }
+            const int axis = normal.x != 0.0f ? 0 : (normal.y != 0.0f ? 1 : 2);
+            const bool negative = (axis == 0 ? normal.x : axis == 1 ? normal.y : normal.z) < 0.0f;
+            int from[3] = {static_cast<int>(lo.x), static_cast<int>(lo.y), static_cast<int>(lo.z)};
+            int to[3] = {static_cast<int>(hi.x), static_cast<int>(hi.y), static_cast<int>(hi.z)};
+            // the face sits on the far side of the voxel if it points the positive way
+            if (!negative) from[axis]--;
+            to[axis] = from[axis] + 1;
+
+            const uint64_t key = (static_cast<uint64_t>(mat.id) << 40) | (static_cast<uint64_t>(axis * 2 + negative) << 32);
+            for (int z = from[2]; z < to[2]; z++) {
+                for (int y = from[1]; y < to[1]; y++) {
+                    for (int x = from[0]; x < to[0]; x++) {
+                        faces.emplace_back(key | static_cast<uint64_t>(ChunkLayout<N>::index(x, y, z)));
+                    }
+                }
+            }
+        }
+    }
+    std::sort(faces.begin(), faces.end());
+    return true;
+}
+
+// Binary has to make exactly the quads of Naive, Greedy has to cover the same faces with fewer of them
+template<int N>
+static bool meshersAgree(const BasicVoxelChunk<N>& chunk, const int height) {
+    std::vector<uint64_t> expected, faces;
+    bool ok = true;
+    int naive_vertices = 0;
+    for (const auto& [mesher, name] : MESHERS) {
+        std::vector<MaterialMesh> meshes = build_chunk_mesh_data<N>(chunk, Vector3{0, 0, 0}, 1.0f, height, mesher);
+        int vertices = 0;
+        for (const MaterialMesh& mat : meshes) vertices += mat.mesh.vertexCount;
+
+        if (mesher == ChunkMesher::Naive) {
+            ok = getCoveredFaces<N>(meshes, expected) && ok;
+            naive_vertices = vertices;
+        } else {
+            ok = getCoveredFaces<N>(meshes, faces) && faces == expected && ok;
+            if (mesher == ChunkMesher::Binary) ok = ok && vertices == naive_vertices;
+            else ok = ok && vertices <= naive_vertices;
+        }
+        for (MaterialMesh& mat : meshes) UnloadMesh(mat.mesh);
+    }
+    return ok;
+}
+
+// Remeshes the whole map cut into chunks of N^3 with every mesher, the terrain is the same for every N.
+// Returns false if the meshers don't agree or a mesh went over MESH_MAX_VERTICES.
+template<int N>
+static bool benchChunkSize(VoxelMap& map, const int size, const int repeats) {
+    const int count = (size + N - 1) / N;
+    const int height = std::min(N, CHUNK_SIZE); // nothing above it, like ChunkSummary::height in the game
+    std::vector<BasicVoxelChunk<N>> chunks(count * count);
+    for (int cy = 0; cy < count; cy++) {
+        for (int cx = 0; cx < count; cx++) {
+            BasicVoxelChunk<N>& chunk = chunks[cx + cy * count];
+            chunk.fill(0);
+            for (int z = 0; z < height; z++) {
+                for (int y = 0; y < N; y++) {
+                    for (int x = 0; x < N; x++) {
+                        const VoxelID* voxel = map.get_voxel({cx * N + x, cy * N + y, z});
+                        if (voxel != nullptr) chunk[ChunkLayout<N>::index(x, y, z)] = *voxel;
+                    }
+                }
+            }
+        }
+    }
+
+    bool ok = true;
+    for (const BasicVoxelChunk<N>& chunk : chunks) {
+        ok = meshersAgree<N>(chunk, height) && ok;
+    }
+    if (!ok) TraceLog(LOG_WARNING, "[Bench] %i^3: the meshers don't cover the same faces", N);
+
+    for (const auto& [mesher, name] : MESHERS) {
+        double best = 1e30;
+        int draw_calls = 0, splits = 0, max_vertices = 0;
+        long long triangles = 0;
+        size_t bytes = 0;
+        for (int r = 0; r < repeats; r++) {
+            draw_calls = splits = max_vertices = 0;
+            triangles = 0;
+            bytes = 0;
+            double time = 0.0;
+            for (const BasicVoxelChunk<N>& chunk : chunks) {
+                const double t = bench::now();
+                std::vector<MaterialMesh> meshes = build_chunk_mesh_data<N>(chunk, Vector3{0, 0, 0}, 1.0f, height, mesher);
+                time += bench::now() - t;
+
+                std::set<VoxelID> materials;
+                for (MaterialMesh& mat : meshes) {
+                    materials.insert(mat.id);
+                    triangles += mat.mesh.triangleCount;
+                    max_vertices = std::max(max_vertices, mat.mesh.vertexCount);
+                    bytes += get_mesh_bytes(mat.mesh);
+                    UnloadMesh(mat.mesh); // never uploaded, only frees the CPU copy
+                }
+                draw_calls += static_cast<int>(meshes.size());
+                splits += static_cast<int>(meshes.size() - materials.size());
+            }
+            best = std::min(best, time);
+        }
+
+        TraceLog(LOG_INFO, "[Bench] %2i^3 %-6s: %6i chunks, %6i draw calls (%i split), %9lld triangles, %6.1f MB, "
+            "%7.3f ms per chunk, %7.1f ms for the map",
+            N, name, count * count, draw_calls, splits, triangles, bytes / (1024.0 * 1024.0),
+            best * 1000.0 / static_cast<double>(chunks.size()), best * 1000.0);
+        ok = ok && max_vertices <= MESH_MAX_VERTICES;
+    }
+    return ok;
+}
+
+// Random voxels of a few materials at a few densities, the terrain alone doesn't have many odd shapes
+template<int N>
+static bool randomChunksAgree(const int count) {
+    std::mt19937 rng(N);
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        const int density = std::uniform_int_distribution<int>(1, 99)(rng);
+        const int height = std::uniform_int_distribution<int>(1, N)(rng);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> material(1, 4);
+        BasicVoxelChunk<N> chunk{};
+        for (VoxelID& v : chunk) v = percent(rng) < density ? static_cast<VoxelID>(material(rng)) : 0;
+        ok = meshersAgree<N>(chunk, height) && ok;
+    }
+    TraceLog(ok ? LOG_INFO : LOG_WARNING, "[Bench] %i^3: %i random chunks %s",
+        N, count, ok ? "meshed the same by every mesher" : "NOT meshed the same by every mesher");
+    return ok;
+}
+
+// Worst case for the vertex limit: every other voxel solid, none of their faces touch
+template<int N>
+static bool checkerboardFits() {
+    BasicVoxelChunk<N> chunk{};
+    int solid = 0;
+    for (int z = 0; z < N; z++) {
+        for (int y = 0; y < N; y++) {
+            for (int x = 0; x < N; x++) {
+                if ((x + y + z) % 2 == 0) continue;
+                chunk[ChunkLayout<N>::index(x, y, z)] = 1;
+                solid++;
+            }
+        }
+    }
+
+    std::vector<MaterialMesh> meshes = build_chunk_mesh_data<N>(chunk, Vector3{0, 0, 0}, 1.0f, N, ChunkMesher::Binary);
+    bool fits = true;
+    long long vertices = 0;
+    for (MaterialMesh& mat : meshes) {
+        fits = fits && mat.mesh.vertexCount <= MESH_MAX_VERTICES;
+        vertices += mat.mesh.vertexCount;
+        UnloadMesh(mat.mesh);
+    }
+    fits = fits && vertices == solid * 6LL * 4;
+    TraceLog(fits ? LOG_INFO : LOG_WARNING, "[Bench] %i^3 checkerboard: %lld vertices in %i meshes%s",
+        N, vertices, static_cast<int>(meshes.size()), fits ? "" : ", WRONG");
+    return fits;
+}
+
+int bench::chunks(const BenchArgs& args) {
+    const int size = getIntArg(args, 0, 512);
+    const int repeats = std::max(1, getIntArg(args, 1, 3));
+
+    double t = now();
+    VoxelMap map(size, size);
+    TraceLog(LOG_INFO, "[Bench] generated a %ix%i map in %.1f ms (CHUNK_SIZE %i)",
+        size, size, (now() - t) * 1000.0, CHUNK_SIZE);
+
+    bool ok = true;
+    ok = benchChunkSize<16>(map, size, repeats) && ok;
+    ok = benchChunkSize<32>(map, size, repeats) && ok;
+    ok = benchChunkSize<64>(map, size, repeats) && ok;
+
+    ok = checkerboardFits<16>() && ok;
+    ok = checkerboardFits<32>() && ok;
+    ok = checkerboardFits<64>() && ok;
+
+    ok = randomChunksAgree<16>(200) && ok;
+    ok = randomChunksAgree<32>(50) && ok;
+    ok = randomChunksAgree<64>(10) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <cstring>
+#include <raylib.h>
+#include "economy/Economy.hpp"
+
+// FNV-1a over the bits of every stockpile and town
+static uint64_t hashEconomy(const Economy& economy) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&](const float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ull;
+    };
+    for (const float f : economy.industry_input) add(f);
+    for (const float f : economy.industry_output) add(f);
+    for (const float f : economy.town_population) add(f);
+    add(static_cast<float>(economy.get_stats().money));
+    return hash;
+}
+
+int bench::economy(const BenchArgs& args) {
+    const int years = getIntArg(args, 0, 10);
+    const int industry_count = getIntArg(args, 1, 20000);
+    const int town_count = getIntArg(args, 2, 2000);
+    const int threads = getIntArg(args, 3, 0); // 0: one per core
+    const int size = 4096;
+    const int days = years * ECONOMY_MONTHS_PER_YEAR * ECONOMY_DAYS_PER_MONTH;
+
+    JobPool single(0);
+    JobPool all(threads > 0 ? threads - 1 : -1);
+    JobPool* pools[2] = {&single, &all};
+    uint64_t hashes[2];
+
+    for (int p = 0; p < 2; p++) {
+        Economy economy;
+        double t = now();
+        economy.generate(Int2{size, size}, town_count, industry_count, 1234, *pools[p]);
+        const double generated = now() - t;
+
+        t = now();
+        for (int day = 0; day < days; day++) economy.tick(*pools[p]);
+        const double elapsed = now() - t;
+        hashes[p] = hashEconomy(economy);
+
+        const EconomyStats stats = economy.get_stats();
+        TraceLog(LOG_INFO, "[Bench] %i threads: linked %i industries and %i towns (%i links) in %.1f ms",
+            pools[p]->get_thread_count(), stats.industries, stats.towns, stats.links, generated * 1000.0);
+        TraceLog(LOG_INFO, "[Bench] %i threads: %i years in %.2f s, %.0f ticks/s (%.3f ms per day)",
+            pools[p]->get_thread_count(), years, elapsed, days / elapsed, elapsed * 1000.0 / days);
+        TraceLog(LOG_INFO, "[Bench] $%.0f earned, %.0f cargo delivered last month, %lld people",
+            stats.money, stats.delivered_last_month, stats.population);
+    }
+    if (hashes[0] != hashes[1]) {
+        TraceLog(LOG_WARNING, "[Bench] results depend on the thread count");
+        return 1;
+    }
+    TraceLog(LOG_INFO, "[Bench] same results with 1 and %i threads", all.get_thread_count());
+    return 0;
+}
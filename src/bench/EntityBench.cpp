@@ -0,0 +1,79 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <cmath>
+#include <random>
+#include <raylib.h>
+#include "entity/EntityStore.hpp"
+
+int bench::entities(const BenchArgs& args) {
+    const int count = getIntArg(args, 0, 100000);
+    const int ticks = getIntArg(args, 1, 300);
+
+    EntityStore store;
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> coord(0.0f, 1024.0f);
+    std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+
+    double t = now();
+    std::vector<EntityId> handles;
+    handles.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const EntityKind kind = (i % 8 == 0) ? BUILDING_ENTITY : VEHICLE_ENTITY;
+        handles.emplace_back(store.create(kind, Vector3{coord(rng), coord(rng), 0.0f}, kind));
+        if (kind == VEHICLE_ENTITY) store.velocities.back() = Vector2{speed(rng), speed(rng)};
+    }
+    TraceLog(LOG_INFO, "[Bench] created %i entities in %.2f ms", count, (now() - t) * 1000.0);
+
+    // Churn: a third of them replaced, the old handles must all be dead afterwards
+    t = now();
+    std::vector<EntityId> destroyed;
+    destroyed.reserve(count / 3 + 1);
+    for (int i = 0; i < count; i += 3) {
+        store.destroy(handles[i]);
+        destroyed.emplace_back(handles[i]);
+        handles[i] = store.create(VEHICLE_ENTITY, Vector3{coord(rng), coord(rng), 0.0f}, 0);
+    }
+    TraceLog(LOG_INFO, "[Bench] replaced %i entities in %.2f ms", (count + 2) / 3, (now() - t) * 1000.0);
+    for (const EntityId& id : handles) {
+        if (!store.is_alive(id)) {
+            TraceLog(LOG_WARNING, "[Bench] live handle %u:%u reported dead", id.slot, id.generation);
+            return 1;
+        }
+    }
+    // The new entities took the freed slots, a stale handle must not reach them
+    int reused = 0;
+    for (size_t i = 0; i < destroyed.size(); i++) {
+        const EntityId& old_id = destroyed[i];
+        if (store.is_alive(old_id) || store.get_index(old_id) >= 0) {
+            TraceLog(LOG_WARNING, "[Bench] destroyed handle %u:%u reported alive", old_id.slot, old_id.generation);
+            return 1;
+        }
+        if (handles[i * 3].slot == old_id.slot) reused++;
+    }
+    if (reused == 0) {
+        TraceLog(LOG_WARNING, "[Bench] no slot was reused, the stale handles weren't tested");
+        return 1;
+    }
+
+    // The kind of loop a system runs: straight over the arrays it needs
+    t = now();
+    const float step = 1.0f / 30.0f;
+    for (int tick = 0; tick < ticks; tick++) {
+        Vector3* positions = store.positions.data();
+        const Vector2* velocities = store.velocities.data();
+        float* headings = store.headings.data();
+        for (size_t i = 0; i < store.size(); i++) {
+            positions[i].x += velocities[i].x * step;
+            positions[i].y += velocities[i].y * step;
+            headings[i] = std::atan2(velocities[i].y, velocities[i].x);
+        }
+    }
+    const double elapsed = now() - t;
+    TraceLog(LOG_INFO, "[Bench] %i ticks of %zu entities in %.1f ms: %.2f ns per entity per tick",
+        ticks, store.size(), elapsed * 1000.0, elapsed * 1e9 / (static_cast<double>(ticks) * store.size()));
+    return 0;
+}
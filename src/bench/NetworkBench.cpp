@@ -0,0 +1,93 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <random>
+#include <raylib.h>
+#include "network/TransportNetwork.hpp"
+
+int bench::network(const BenchArgs& args) {
+    const int size = getIntArg(args, 0, 1024);
+    const int edit_count = getIntArg(args, 1, 20000);
+    const int query_count = getIntArg(args, 2, 200000);
+
+    VoxelMap map(size, size);
+    TransportNetwork network(&map);
+
+    // A grid of roads every 8 tiles, with gaps wherever the terrain is too steep
+    double t = now();
+    for (int line = 0; line < size; line += 8) {
+        for (int i = 1; i < size; i++) {
+            network.add_link({i - 1, line}, {i, line});
+            network.add_link({line, i - 1}, {line, i});
+        }
+    }
+    NetworkStats stats = network.get_stats();
+    TraceLog(LOG_INFO, "[Bench] built %i road tiles, %i networks, in %.1f ms",
+        stats.road_tiles, stats.components, (now() - t) * 1000.0);
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    std::uniform_int_distribution<int> direction(0, 3);
+    auto random_road_tile = [&] {
+        Int2 tile{};
+        do {
+            tile = {coord(rng) / 8 * 8, coord(rng)};
+            if (rng() % 2) std::swap(tile.x, tile.y);
+        } while (!network.has_road(tile));
+        return tile;
+    };
+
+    // Players building and demolishing single pieces of road
+    t = now();
+    int added = 0, removed = 0;
+    for (int i = 0; i < edit_count; i++) {
+        const Int2 a = {coord(rng), coord(rng)};
+        static const Int2 steps[4] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+        const Int2 step = steps[direction(rng)];
+        const Int2 b = {a.x + step.x, a.y + step.y};
+        if (i % 2 == 0) added += network.add_link(a, b);
+        else removed += network.remove_link(a, b);
+    }
+    const double edit_time = now() - t;
+    stats = network.get_stats();
+    TraceLog(LOG_INFO, "[Bench] %i edits (%i built, %i removed, %i splits) in %.1f ms: %.2f us per edit",
+        edit_count, added, removed, stats.splits, edit_time * 1000.0, edit_time * 1e6 / edit_count);
+
+    std::vector<std::pair<Int2, Int2>> pairs;
+    for (int i = 0; i < 256; i++) pairs.emplace_back(random_road_tile(), random_road_tile());
+
+    t = now();
+    int connected = 0;
+    for (int i = 0; i < query_count; i++) {
+        const auto& [a, b] = pairs[i % pairs.size()];
+        connected += network.is_connected(a, b);
+    }
+    const double query_time = now() - t;
+    TraceLog(LOG_INFO, "[Bench] %i connectivity queries (%i connected) in %.1f ms: %.0f ns per query",
+        query_count, connected, query_time * 1000.0, query_time * 1e9 / query_count);
+
+    // First lookup of every pair searches, the rest come from the cache
+    for (int pass = 0; pass < 2; pass++) {
+        t = now();
+        long long tiles = 0;
+        for (const auto& [a, b] : pairs) {
+            const std::vector<Int2>& route = network.find_route(a, b);
+            if (network.is_connected(a, b) && (route.empty() || !(route.front() == a) || !(route.back() == b))) {
+                TraceLog(LOG_WARNING, "[Bench] no route between connected tiles (%i, %i) and (%i, %i)",
+                    a.x, a.y, b.x, b.y);
+                return 1;
+            }
+            tiles += static_cast<long long>(route.size());
+        }
+        const double elapsed = now() - t;
+        TraceLog(LOG_INFO, "[Bench] %s: %zu routes, %.1f tiles on average, %.2f us per route",
+            pass == 0 ? "searched" : "cached", pairs.size(), static_cast<double>(tiles) / pairs.size(),
+            elapsed * 1e6 / pairs.size());
+    }
+    stats = network.get_stats();
+    TraceLog(LOG_INFO, "[Bench] route cache: %i hits, %i misses", stats.route_hits, stats.route_misses);
+    return 0;
+}
@@ -0,0 +1,135 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <raylib.h>
+#include <raymath.h>
+#include "render/Frustum.hpp"
+#include "render/OcclusionCuller.hpp"
+#include "voxel/VoxelRaycast.hpp"
+#include "game/main.hpp"
+
+#define OCCLUSION_ASPECT (16.0f / 9.0f)
+
+// True if the world point is inside the view, same clip test as the GPU
+static bool isOnScreen(const Matrix& view_proj, const Vector3 v) {
+    const float x = v.x * view_proj.m0 + v.y * view_proj.m4 + v.z * view_proj.m8 + view_proj.m12;
+    const float y = v.x * view_proj.m1 + v.y * view_proj.m5 + v.z * view_proj.m9 + view_proj.m13;
+    const float z = v.x * view_proj.m2 + v.y * view_proj.m6 + v.z * view_proj.m10 + view_proj.m14;
+    const float w = v.x * view_proj.m3 + v.y * view_proj.m7 + v.z * view_proj.m11 + view_proj.m15;
+    return w > 0.0f && std::abs(x) <= w && std::abs(y) <= w && std::abs(z) <= w;
+}
+
+// Brute force: true if a ray from the camera reaches any of the model's triangles.
+// Each triangle is sampled at its centre and near its corners, points off screen don't count.
+static bool isReachable(const std::vector<VoxelGrid*>& grids, const ModelInfo& model_info, const Vector3 eye, const Matrix& view_proj) {
+    for (int m = 0; m < model_info.model.meshCount; m++) {
+        const Mesh& mesh = model_info.model.meshes[m];
+        for (int t = 0; t < mesh.triangleCount; t++) {
+            Vector3 corners[3];
+            for (int c = 0; c < 3; c++) {
+                const int i = mesh.indices != nullptr ? mesh.indices[t * 3 + c] : t * 3 + c;
+                const Vector3 v = {mesh.vertices[i * 3], mesh.vertices[i * 3 + 1], mesh.vertices[i * 3 + 2]};
+                corners[c] = Vector3Transform(v, model_info.world_matrix);
+            }
+            // Faces turned away from the camera are hidden by their own voxel
+            const Vector3 facing = Vector3CrossProduct(Vector3Subtract(corners[1], corners[0]), Vector3Subtract(corners[2], corners[0]));
+            if (Vector3DotProduct(facing, Vector3Subtract(eye, corners[0])) <= 0.0f) continue;
+            const Vector3 centre = Vector3Scale(Vector3Add(Vector3Add(corners[0], corners[1]), corners[2]), 1.0f / 3.0f);
+            const Vector3 samples[4] = {
+                centre,
+                Vector3Lerp(corners[0], centre, 0.1f),
+                Vector3Lerp(corners[1], centre, 0.1f),
+                Vector3Lerp(corners[2], centre, 0.1f),
+            };
+            for (const Vector3 sample : samples) {
+                if (!isOnScreen(view_proj, sample)) continue;
+                const Vector3 to_sample = Vector3Subtract(sample, eye);
+                const float distance = Vector3Length(to_sample);
+                if (distance < 0.001f) return true;
+                // Faces lie on voxel boundaries, stop just short of the one the sample is on
+                const Ray ray = {eye, Vector3Scale(to_sample, 1.0f / distance)};
+                if (!raycast_voxel_grids(grids, ray, distance * 0.999f).has_value()) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Low cameras over a generated map, where the hills hide the most chunks.
+// Every chunk the occlusion culler rejects is checked with raycasts to its triangles,
+// fails if any of them could be seen.
+int bench::occlusion(const BenchArgs& args) {
+    const int size = getIntArg(args, 0, 256);
+    const int view_count = getIntArg(args, 1, 100);
+
+    // Meshes are only kept on the CPU, nothing needs a GPU
+    global::render_backend = &global::null_backend;
+    global::null_backend.open(1, 1, "occlusion");
+
+    VoxelMap map(size, size);
+    map.remesh_budget = 0;
+    map.model_budget = 0;
+    map.update_models();
+    std::vector<ModelInfo*> models = map.get_models();
+    const std::vector<VoxelGrid*> grids = {&map};
+    const float scale = global::voxel_scale;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coord(0.0f, static_cast<float>(size - 1));
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * PI);
+    std::uniform_real_distribution<float> pitch(-0.3f, 0.05f);
+
+    OcclusionCuller culler;
+    long long tested = 0, rejected = 0, wrong = 0;
+    double cull_time = 0.0;
+    for (int v = 0; v < view_count; v++) {
+        const Int2 column = {static_cast<int>(coord(rng)), static_cast<int>(coord(rng))};
+        const float height = static_cast<float>(map.get_surface_height(column)) + 2.0f;
+        const float yaw = angle(rng);
+        Camera3D camera{};
+        camera.position = Vector3Scale(Vector3{static_cast<float>(column.x) + 0.5f, height, static_cast<float>(column.y) + 0.5f}, scale);
+        camera.target = Vector3Add(camera.position, Vector3{std::cos(yaw), pitch(rng), std::sin(yaw)});
+        camera.up = Vector3{0.0f, 1.0f, 0.0f};
+        camera.fovy = 45.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+
+        // Same as updateVisibility()
+        const Matrix view_proj = MatrixMultiply(GetCameraMatrix(camera), getCameraProjection(camera, OCCLUSION_ASPECT));
+        const Frustum frustum = Frustum::from_matrix(view_proj);
+        std::vector<ModelInfo*> visible;
+        for (ModelInfo* model_info : models) {
+            if (frustum.contains(model_info->world_bounds)) visible.push_back(model_info);
+        }
+
+        const double t = now();
+        culler.begin(view_proj);
+        for (const ModelInfo* model_info : visible) {
+            for (const BoundingBox& occluder : model_info->occluders) culler.add_occluder(occluder, model_info->world_matrix);
+        }
+        std::vector<const ModelInfo*> hidden;
+        for (const ModelInfo* model_info : visible) {
+            if (!culler.is_visible(model_info->world_bounds)) hidden.push_back(model_info);
+        }
+        cull_time += now() - t;
+
+        tested += static_cast<long long>(visible.size());
+        rejected += static_cast<long long>(hidden.size());
+        for (const ModelInfo* model_info : hidden) {
+            if (!isReachable(grids, *model_info, camera.position, view_proj)) continue;
+            const BoundingBox& b = model_info->world_bounds;
+            TraceLog(LOG_WARNING, "[Bench] view %i culled a visible chunk at (%.1f, %.1f, %.1f)",
+                v, b.min.x, b.min.y, b.min.z);
+            wrong++;
+        }
+    }
+
+    TraceLog(LOG_INFO, "[Bench] %i views: %lld of %lld chunks rejected, %lld of them visible, %.3f ms per view",
+        view_count, rejected, tested, wrong, cull_time * 1000.0 / std::max(view_count, 1));
+    return wrong > 0 ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <random>
+#include <raylib.h>
+#include "path/TerrainPathfinder.hpp"
+
+int bench::pathfinding(const BenchArgs& args) {
+    const int size = getIntArg(args, 0, 1024);
+    const int path_count = getIntArg(args, 1, 2000);
+    const int edit_count = getIntArg(args, 2, 64);
+
+    double t = now();
+    VoxelMap map(size, size);
+    TraceLog(LOG_INFO, "[Bench] generated a %ix%i map in %.2f s", size, size, now() - t);
+
+    TerrainPathfinder pathfinder(&map);
+    t = now();
+    pathfinder.update();
+    PathStats stats = pathfinder.get_stats();
+    TraceLog(LOG_INFO, "[Bench] abstract graph: %i nodes, %i edges, built in %.1f ms",
+        stats.nodes, stats.edges, (now() - t) * 1000.0);
+
+    // Random pairs of walkable tiles, the same every run
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    auto random_tile = [&] {
+        Int2 tile{};
+        do tile = {coord(rng), coord(rng)}; while (!pathfinder.is_walkable(tile));
+        return tile;
+    };
+    std::vector<std::pair<Int2, Int2>> queries;
+    for (int i = 0; i < path_count; i++) queries.emplace_back(random_tile(), random_tile());
+
+    int found = 0;
+    long long tiles = 0, expanded = 0;
+    t = now();
+    for (const auto& [start, goal] : queries) {
+        auto path = pathfinder.find_path(start, goal);
+        if (!path.empty()) found++;
+        tiles += static_cast<long long>(path.size());
+        expanded += pathfinder.get_stats().expanded;
+    }
+    const double elapsed = now() - t;
+    TraceLog(LOG_INFO, "[Bench] %i paths in %.1f ms: %.0f paths/s, %i found, %.0f tiles and %.0f expanded nodes per path",
+        path_count, elapsed * 1000.0, path_count / elapsed, found,
+        static_cast<double>(tiles) / path_count, static_cast<double>(expanded) / path_count);
+
+    // Terrain edits only rebuild the chunks around them
+    for (int i = 0; i < edit_count; i++) {
+        const Int2 column = {coord(rng), coord(rng)};
+        map.set_voxel(Int3{column.x, column.y, map.get_surface_height(column)}, 1);
+    }
+    t = now();
+    pathfinder.update();
+    TraceLog(LOG_INFO, "[Bench] %i edits: %i chunk graphs rebuilt in %.2f ms",
+        edit_count, pathfinder.get_stats().rebuilt_chunks, (now() - t) * 1000.0);
+    return 0;
+}
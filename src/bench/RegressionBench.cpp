@@ -0,0 +1,190 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <raylib.h>
+#include "voxel/VoxelMesher.hpp"
+#include "game/main.hpp"
+
+// Next to the shaders, the game is run from the build directory
+#define REGRESSION_GOLDEN_DIR "../resources/regression/"
+#define REGRESSION_EDITS 500 // random voxels set on every map, with the same seed every run
+#define REGRESSION_TIME_SLACK_MS 0.5 // on top of the tolerance, so the short timings don't fail on noise
+#ifndef BUILD_TYPE
+#define BUILD_TYPE "None" // set by CMake, the time budgets are kept per build type
+#endif
+
+// What a run measured, in the order it measured it.
+// Keys ending in _ms are times, the rest are counts and have to match exactly.
+using Metrics = std::vector<std::pair<std::string, double>>;
+
+static bool isTime(const std::string& key) {
+    return key.size() > 3 && key.compare(key.size() - 3, 3, "_ms") == 0;
+}
+
+static std::string getGoldenPath() {
+    return REGRESSION_GOLDEN_DIR "golden_" + std::to_string(CHUNK_SIZE) + "_" BUILD_TYPE ".txt";
+}
+
+static bool readGolden(const std::string& path, std::map<std::string, double>& golden) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string key;
+        double value;
+        if (fields >> key >> value) golden[key] = value;
+    }
+    return true;
+}
+
+static bool writeGolden(const std::string& path, const Metrics& metrics) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    file << "# Golden metrics of `business_game --bench regression`, CHUNK_SIZE " << CHUNK_SIZE << ", " BUILD_TYPE " build\n";
+    file << "# Rewritten by `--bench regression update`. Counts must match, *_ms are time budgets.\n";
+    for (const auto& [key, value] : metrics) {
+        if (isTime(key)) file << key << " " << std::ceil(value * 100.0) / 100.0 << "\n";
+        else file << key << " " << static_cast<long long>(value) << "\n";
+    }
+    return true;
+}
+
+// Generates and meshes a size x size map (best time of repeats), then edits it and meshes it again
+static void measureMap(const int size, const int repeats, Metrics& metrics) {
+    const std::string prefix = "map" + std::to_string(size) + "/";
+    double generate_time = 1e30, mesh_time = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        double t = bench::now();
+        VoxelMap map(size, size);
+        generate_time = std::min(generate_time, bench::now() - t);
+
+        // everything at once, nothing evicted
+        map.remesh_budget = 0;
+        map.model_budget = 0;
+        t = bench::now();
+        map.update_models();
+        mesh_time = std::min(mesh_time, bench::now() - t);
+        if (r > 0) continue;
+
+        long long triangles = 0, vertices = 0;
+        for (const auto& [chunk_pos, model_info] : map.chunk_models) {
+            int chunk_triangles = 0, chunk_vertices = 0;
+            for (int i = 0; i < model_info.model.meshCount; i++) {
+                chunk_triangles += model_info.model.meshes[i].triangleCount;
+                chunk_vertices += model_info.model.meshes[i].vertexCount;
+            }
+            const std::string chunk = prefix + "chunk_" + std::to_string(chunk_pos.x) + "_" + std::to_string(chunk_pos.y);
+            metrics.emplace_back(chunk + "/triangles", chunk_triangles);
+            metrics.emplace_back(chunk + "/vertices", chunk_vertices);
+            triangles += chunk_triangles;
+            vertices += chunk_vertices;
+        }
+        metrics.emplace_back(prefix + "triangles", static_cast<double>(triangles));
+        metrics.emplace_back(prefix + "vertices", static_cast<double>(vertices));
+
+        // What the map keeps in memory
+        metrics.emplace_back(prefix + "voxel_bytes", static_cast<double>(map.chunks.size() * sizeof(VoxelChunk)));
+        metrics.emplace_back(prefix + "summary_bytes", static_cast<double>(map.chunk_summaries.size() * sizeof(ChunkSummary)));
+        metrics.emplace_back(prefix + "model_bytes", static_cast<double>(map.model_bytes));
+
+        // Random edits, remeshed through the dirty chunks like in the game.
+        // Straight from mt19937, the distributions give different numbers with every standard library.
+        std::mt19937 rng(size);
+        for (int i = 0; i < REGRESSION_EDITS; i++) {
+            const int x = static_cast<int>(rng() % size);
+            const int y = static_cast<int>(rng() % size);
+            const int z = static_cast<int>(rng() % CHUNK_SIZE);
+            map.set_voxel(Int3{x, y, z}, static_cast<VoxelID>(rng() % 4));
+        }
+        map.update_models();
+        triangles = vertices = 0;
+        for (const auto& [chunk_pos, model_info] : map.chunk_models) {
+            for (int i = 0; i < model_info.model.meshCount; i++) {
+                triangles += model_info.model.meshes[i].triangleCount;
+                vertices += model_info.model.meshes[i].vertexCount;
+            }
+        }
+        metrics.emplace_back(prefix + "edited/triangles", static_cast<double>(triangles));
+        metrics.emplace_back(prefix + "edited/vertices", static_cast<double>(vertices));
+        metrics.emplace_back(prefix + "edited/model_bytes", static_cast<double>(map.model_bytes));
+    }
+    metrics.emplace_back(prefix + "generate_ms", generate_time * 1000.0);
+    metrics.emplace_back(prefix + "mesh_ms", mesh_time * 1000.0);
+    TraceLog(LOG_INFO, "[Bench] %ix%i map: generated in %.2f ms, meshed in %.2f ms",
+        size, size, generate_time * 1000.0, mesh_time * 1000.0);
+}
+
+// Golden metrics of the voxel pipeline for fixed maps and seeds: the triangles and vertices
+// of every chunk, the memory the map holds and how long generating and meshing it takes.
+// Fails if a count changed or a time went more than tolerance % over its budget.
+int bench::regression(const BenchArgs& args) {
+    const bool update = !args.empty() && args[0] == "update";
+    const int tolerance = getIntArg(args, update ? 1 : 0, 50);
+    const int repeats = 5;
+
+    // Meshes are only counted, nothing needs a GPU
+    global::render_backend = &global::null_backend;
+    global::null_backend.open(1, 1, "regression");
+
+    Metrics metrics;
+    for (const int size : {64, 256}) measureMap(size, repeats, metrics);
+
+    const std::string path = getGoldenPath();
+    if (update) {
+        if (!writeGolden(path, metrics)) {
+            TraceLog(LOG_WARNING, "[Bench] couldn't write %s", path.c_str());
+            return 1;
+        }
+        TraceLog(LOG_INFO, "[Bench] wrote %zu golden metrics to %s", metrics.size(), path.c_str());
+        return 0;
+    }
+
+    std::map<std::string, double> golden;
+    if (!readGolden(path, golden)) {
+        TraceLog(LOG_WARNING, "[Bench] no golden metrics at %s, make them with `--bench regression update`", path.c_str());
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto& [key, value] : metrics) {
+        const auto expected = golden.find(key);
+        if (expected == golden.end()) {
+            TraceLog(LOG_WARNING, "[Bench] %s = %g, not in the golden metrics", key.c_str(), value);
+            failures++;
+            continue;
+        }
+        if (isTime(key)) {
+            const double budget = expected->second * (1.0 + tolerance / 100.0) + REGRESSION_TIME_SLACK_MS;
+            if (value > budget) {
+                TraceLog(LOG_WARNING, "[Bench] %s took %.2f ms, the budget is %.2f ms (+%i%%)",
+                    key.c_str(), value, expected->second, tolerance);
+                failures++;
+            }
+        } else if (value != expected->second) {
+            TraceLog(LOG_WARNING, "[Bench] %s = %.0f, was %.0f", key.c_str(), value, expected->second);
+            failures++;
+        }
+        golden.erase(expected);
+    }
+    for (const auto& [key, value] : golden) {
+        TraceLog(LOG_WARNING, "[Bench] %s is in the golden metrics, but wasn't measured", key.c_str());
+        failures++;
+    }
+
+    if (failures > 0) {
+        TraceLog(LOG_WARNING, "[Bench] %i of %zu metrics drifted from %s", failures, metrics.size(), path.c_str());
+        return 1;
+    }
+    TraceLog(LOG_INFO, "[Bench] all %zu metrics match %s", metrics.size(), path.c_str());
+    return 0;
+}
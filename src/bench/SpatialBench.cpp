@@ -0,0 +1,142 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <algorithm>
+#include <random>
+#include <raylib.h>
+#include <raymath.h>
+#include "render/SpatialIndex.hpp"
+#include "voxel/VoxelGrid.hpp"
+
+// Props scattered over a big map, a few of them moving every frame.
+// Every query is checked against testing all the props one by one.
+int bench::spatial(const BenchArgs& args) {
+    const int prop_count = getIntArg(args, 0, 100000);
+    const int frame_count = getIntArg(args, 1, 200);
+    const float world = 2000.0f;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(0.0f, world);
+    std::uniform_real_distribution<float> size(0.2f, 3.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<ModelInfo> props(prop_count);
+    auto place = [&](ModelInfo& prop, const Vector3 at) {
+        const Vector3 extent = {size(rng), size(rng), size(rng)};
+        prop.world_bounds = BoundingBox{at, Vector3Add(at, extent)};
+    };
+    for (ModelInfo& prop : props) place(prop, Vector3{coord(rng), coord(rng) * 0.001f, coord(rng)});
+
+    SpatialIndex index;
+    double t = now();
+    for (ModelInfo& prop : props) index.update(&prop, nullptr);
+    SpatialIndexStats stats = index.get_stats();
+    TraceLog(LOG_INFO, "[Bench] indexed %i props in %.1f ms, tree height %i",
+        stats.items, (now() - t) * 1000.0, stats.height);
+
+    std::vector<SpatialItem> found;
+    std::vector<const ModelInfo*> expected, got;
+    int mismatches = 0;
+    auto check = [&](auto&& brute_force) {
+        expected.clear();
+        for (const ModelInfo& prop : props) {
+            if (brute_force(prop.world_bounds)) expected.emplace_back(&prop);
+        }
+        got.clear();
+        for (const SpatialItem& item : found) got.emplace_back(item.model);
+        std::sort(expected.begin(), expected.end());
+        std::sort(got.begin(), got.end());
+        if (expected != got) mismatches++;
+    };
+
+    double move_time = 0.0, frustum_time = 0.0, radius_time = 0.0, ray_time = 0.0;
+    long long frustum_found = 0, radius_found = 0, ray_found = 0;
+    std::uniform_int_distribution<int> pick(0, prop_count - 1);
+    for (int frame = 0; frame < frame_count; frame++) {
+        // 1% of the props drive a bit further
+        t = now();
+        for (int i = 0; i < prop_count / 100; i++) {
+            ModelInfo& prop = props[pick(rng)];
+            const Vector3 step = {unit(rng) * 0.5f, 0.0f, unit(rng) * 0.5f};
+            prop.world_bounds.min = Vector3Add(prop.world_bounds.min, step);
+            prop.world_bounds.max = Vector3Add(prop.world_bounds.max, step);
+            index.update(&prop, nullptr);
+        }
+        move_time += now() - t;
+
+        // A camera somewhere over the map, looking down at an angle
+        Camera3D camera{};
+        camera.position = Vector3{coord(rng), 20.0f, coord(rng)};
+        camera.target = Vector3Add(camera.position, Vector3{unit(rng) * 30.0f, -15.0f, unit(rng) * 30.0f});
+        camera.up = Vector3{0.0f, 1.0f, 0.0f};
+        camera.fovy = 60.0f;
+        camera.projection = CAMERA_PERSPECTIVE;
+        const Frustum frustum = Frustum::from_camera(camera, 16.0f / 9.0f);
+
+        t = now();
+        index.query_frustum(frustum, found);
+        frustum_time += now() - t;
+        frustum_found += static_cast<long long>(found.size());
+        if (frame % 10 == 0) check([&](const BoundingBox& box) { return frustum.contains(box); });
+
+        const float radius = 50.0f;
+        t = now();
+        index.query_radius(camera.position, radius, found);
+        radius_time += now() - t;
+        radius_found += static_cast<long long>(found.size());
+        if (frame % 10 == 0) check([&](const BoundingBox& box) {
+            const Vector3 closest = Vector3Max(box.min, Vector3Min(camera.position, box.max));
+            return Vector3DistanceSqr(closest, camera.position) <= radius * radius;
+        });
+
+        // Picking a prop from near the ground
+        const Vector3 eye = {camera.position.x, 1.0f, camera.position.z};
+        const Ray ray = {eye, Vector3Normalize(Vector3{unit(rng), 0.0f, unit(rng)})};
+        t = now();
+        index.query_ray(ray, 200.0f, found);
+        ray_time += now() - t;
+        ray_found += static_cast<long long>(found.size());
+        if (frame % 10 == 0) check([&](const BoundingBox& box) {
+            const RayCollision hit = GetRayCollisionBox(ray, box);
+            const bool inside = Vector3Equals(Vector3Max(box.min, Vector3Min(ray.position, box.max)), ray.position);
+            return inside || (hit.hit && hit.distance <= 200.0f);
+        });
+    }
+
+    stats = index.get_stats();
+    const double frames = frame_count;
+    TraceLog(LOG_INFO, "[Bench] moves: %i per frame, %.1f us per frame, %i reinserted, tree height %i",
+        prop_count / 100, move_time * 1e6 / frames, stats.reinserts, stats.height);
+    TraceLog(LOG_INFO, "[Bench] frustum: %.1f us, %lld props found per query",
+        frustum_time * 1e6 / frames, frustum_found / frame_count);
+    TraceLog(LOG_INFO, "[Bench] radius:  %.1f us, %lld props found per query",
+        radius_time * 1e6 / frames, radius_found / frame_count);
+    TraceLog(LOG_INFO, "[Bench] ray:     %.1f us, %lld props found per query",
+        ray_time * 1e6 / frames, ray_found / frame_count);
+
+    // What updateVisibility() did before: every prop against the frustum
+    Camera3D camera{};
+    camera.position = Vector3{world / 2, 20.0f, world / 2};
+    camera.target = Vector3{world / 2 + 30.0f, 5.0f, world / 2};
+    camera.up = Vector3{0.0f, 1.0f, 0.0f};
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+    const Frustum frustum = Frustum::from_camera(camera, 16.0f / 9.0f);
+    t = now();
+    int linear_found = 0;
+    for (const ModelInfo& prop : props) linear_found += frustum.contains(prop.world_bounds);
+    const double linear_time = now() - t;
+    t = now();
+    index.query_frustum(frustum, found);
+    TraceLog(LOG_INFO, "[Bench] one frustum, linear scan: %.1f us, index: %.1f us (%i props)",
+        linear_time * 1e6, (now() - t) * 1e6, linear_found);
+
+    if (mismatches > 0) {
+        TraceLog(LOG_WARNING, "[Bench] %i queries didn't match testing every prop", mismatches);
+        return 1;
+    }
+    return 0;
+}
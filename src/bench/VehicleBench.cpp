@@ -0,0 +1,94 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "bench/Bench.hpp"
+
+#include <cstring>
+#include <random>
+#include <raylib.h>
+#include "path/TerrainPathfinder.hpp"
+#include "sim/VehicleSystem.hpp"
+
+// Same vehicles every time: half on routes, half driving free
+static void spawnVehicles(EntityStore& store, const RouteTable& routes, const Heightmap& terrain, const int count) {
+    std::mt19937 rng(77);
+    std::uniform_real_distribution<float> map_x(0.0f, static_cast<float>(terrain.width));
+    std::uniform_real_distribution<float> map_y(0.0f, static_cast<float>(terrain.height));
+    std::uniform_real_distribution<float> speed(-6.0f, 6.0f);
+    store.clear();
+    store.reserve(count);
+    for (int i = 0; i < count; i++) {
+        store.create(VEHICLE_ENTITY, Vector3{map_x(rng), map_y(rng), 0.0f}, 0);
+        store.velocities.back() = Vector2{speed(rng), speed(rng)};
+        if (i % 2 == 0 && !routes.routes.empty()) {
+            const int route = i / 2 % static_cast<int>(routes.routes.size());
+            store.routes.back() = route;
+            store.route_segments.back() = rng() % routes.routes[route].points.size();
+            store.speeds.back() = 2.0f + std::abs(speed(rng));
+        }
+    }
+}
+
+// FNV-1a over the bits of every position and heading
+static uint64_t hashVehicles(const EntityStore& store) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&](const float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ull;
+    };
+    for (size_t i = 0; i < store.size(); i++) {
+        add(store.positions[i].x);
+        add(store.positions[i].y);
+        add(store.positions[i].z);
+        add(store.headings[i]);
+    }
+    return hash;
+}
+
+int bench::vehicles(const BenchArgs& args) {
+    const int ticks = getIntArg(args, 0, 300);
+    const int size = getIntArg(args, 1, 512);
+    const int threads = getIntArg(args, 2, 0); // 0: one per core
+
+    VoxelMap map(size, size);
+    Heightmap terrain;
+    terrain.load(map);
+    TerrainPathfinder pathfinder(&map);
+    pathfinder.update();
+
+    std::mt19937 rng(4321);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    RouteTable routes;
+    for (int i = 0; i < 256 && routes.routes.size() < 64; i++) {
+        routes.add(pathfinder.find_path({coord(rng), coord(rng)}, {coord(rng), coord(rng)}));
+    }
+    TraceLog(LOG_INFO, "[Bench] %zu routes on a %ix%i map", routes.routes.size(), size, size);
+
+    JobPool single(0);
+    JobPool all(threads > 0 ? threads - 1 : -1);
+    const float dt = 1.0f / 30.0f;
+    EntityStore store;
+
+    for (const int count : {10000, 100000}) {
+        uint64_t hashes[2];
+        JobPool* pools[2] = {&single, &all};
+        for (int p = 0; p < 2; p++) {
+            spawnVehicles(store, routes, terrain, count);
+            const double t = now();
+            for (int tick = 0; tick < ticks; tick++) updateVehicles(store, routes, terrain, dt, *pools[p]);
+            const double elapsed = now() - t;
+            hashes[p] = hashVehicles(store);
+            TraceLog(LOG_INFO, "[Bench] %i vehicles, %i threads: %.2f ms per tick, %.0f vehicles per ms",
+                count, pools[p]->get_thread_count(), elapsed * 1000.0 / ticks,
+                static_cast<double>(count) * ticks / (elapsed * 1000.0));
+        }
+        if (hashes[0] != hashes[1]) {
+            TraceLog(LOG_WARNING, "[Bench] %i vehicles: results depend on the thread count", count);
+            return 1;
+        }
+    }
+    TraceLog(LOG_INFO, "[Bench] same results with 1 and %i threads", all.get_thread_count());
+    return 0;
+}
@@ -0,0 +1,210 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "economy/Economy.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+// Cargo towns accept
+static bool townAccepts(const CargoType cargo) {
+    return cargo == FOOD_CARGO || cargo == GOODS_CARGO;
+}
+
+void Economy::clear() {
+    industry_types.clear();
+    industry_tiles.clear();
+    industry_input.clear();
+    industry_output.clear();
+    industry_shipped.clear();
+    industry_links.clear();
+    link_distances.clear();
+    town_tiles.clear();
+    town_population.clear();
+    town_supplied.clear();
+    incoming_offsets.clear();
+    incoming_sources.clear();
+    day = 0;
+    money = income_this_month = income_last_month = 0.0;
+    delivered_this_month = delivered_last_month = 0.0;
+}
+
+void Economy::generate(const Int2 size, const int town_count, const int industry_count, const uint32_t seed,
+    JobPool& pool) {
+    clear();
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> tile_x(0, size.x - 1);
+    std::uniform_int_distribution<int> tile_y(0, size.y - 1);
+    std::uniform_real_distribution<float> population(200.0f, 2000.0f);
+    std::uniform_int_distribution<int> type(0, INDUSTRY_TYPE_COUNT - 1);
+
+    for (int i = 0; i < town_count; i++) {
+        town_tiles.emplace_back(Int2{tile_x(rng), tile_y(rng)});
+        town_population.emplace_back(population(rng));
+        town_supplied.emplace_back(0.0f);
+    }
+    for (int i = 0; i < industry_count; i++) {
+        industry_types.emplace_back(static_cast<IndustryType>(type(rng)));
+        industry_tiles.emplace_back(Int2{tile_x(rng), tile_y(rng)});
+        industry_input.emplace_back(0.0f);
+        industry_output.emplace_back(0.0f);
+        industry_shipped.emplace_back(0.0f);
+    }
+    build_links(pool);
+}
+
+void Economy::build_links(JobPool& pool) {
+    const size_t industry_count = industry_types.size();
+    industry_links.assign(industry_count, -1);
+    link_distances.assign(industry_count, 0.0f);
+
+    // Destinations of every cargo, bucketed into cells as big as the longest link,
+    // so an industry only has to look at its own cell and the 8 around it
+    const int cell = ECONOMY_MAX_LINK_DISTANCE;
+    Int2 cells = {1, 1};
+    for (const Int2 tile : industry_tiles) cells = {std::max(cells.x, tile.x / cell + 1), std::max(cells.y, tile.y / cell + 1)};
+    for (const Int2 tile : town_tiles) cells = {std::max(cells.x, tile.x / cell + 1), std::max(cells.y, tile.y / cell + 1)};
+    std::vector<std::vector<int>> buckets[CARGO_TYPE_COUNT];
+    for (auto& cargo_buckets : buckets) cargo_buckets.resize(cells.x * cells.y);
+    auto bucket_of = [&](const Int2 tile) { return tile.x / cell + tile.y / cell * cells.x; };
+    for (size_t j = 0; j < industry_count; j++) {
+        const CargoType accepts = INDUSTRY_INFO[industry_types[j]].accepts;
+        if (accepts != NO_CARGO) buckets[accepts][bucket_of(industry_tiles[j])].emplace_back(static_cast<int>(j));
+    }
+    for (size_t t = 0; t < town_tiles.size(); t++) {
+        for (int cargo = 0; cargo < CARGO_TYPE_COUNT; cargo++) {
+            if (townAccepts(static_cast<CargoType>(cargo))) {
+                buckets[cargo][bucket_of(town_tiles[t])].emplace_back(static_cast<int>(industry_count + t));
+            }
+        }
+    }
+
+    // Closest destination of every industry, each one on its own
+    pool.parallel_for(industry_count, ECONOMY_BATCH_SIZE, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const CargoType cargo = INDUSTRY_INFO[industry_types[i]].produces;
+            if (cargo == NO_CARGO) continue;
+            const Int2 from = industry_tiles[i];
+            int best = -1, best_distance = ECONOMY_MAX_LINK_DISTANCE + 1;
+            for (int cy = std::max(from.y / cell - 1, 0); cy <= std::min(from.y / cell + 1, cells.y - 1); cy++) {
+                for (int cx = std::max(from.x / cell - 1, 0); cx <= std::min(from.x / cell + 1, cells.x - 1); cx++) {
+                    for (const int destination : buckets[cargo][cx + cy * cells.x]) {
+                        const Int2 to = destination < static_cast<int>(industry_count)
+                            ? industry_tiles[destination] : town_tiles[destination - industry_count];
+                        const int distance = std::abs(to.x - from.x) + std::abs(to.y - from.y);
+                        // ties go to the lowest index, whatever order the buckets are in
+                        if (distance < best_distance || (distance == best_distance && destination < best)) {
+                            best = destination;
+                            best_distance = distance;
+                        }
+                    }
+                }
+            }
+            industry_links[i] = best;
+            link_distances[i] = static_cast<float>(best_distance);
+        }
+    });
+
+    // Turned around: who ships to each destination, in industry order
+    incoming_offsets.assign(get_destination_count() + 1, 0);
+    for (const int destination : industry_links) {
+        if (destination >= 0) incoming_offsets[destination + 1]++;
+    }
+    for (size_t d = 1; d < incoming_offsets.size(); d++) incoming_offsets[d] += incoming_offsets[d - 1];
+    incoming_sources.assign(incoming_offsets.back(), 0);
+    std::vector<uint32_t> filled(incoming_offsets.begin(), incoming_offsets.end() - 1);
+    for (size_t i = 0; i < industry_count; i++) {
+        if (industry_links[i] >= 0) incoming_sources[filled[industry_links[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+void Economy::produce(const size_t begin, const size_t end) {
+    double income = 0.0, delivered = 0.0;
+    for (size_t i = begin; i < end; i++) {
+        const IndustryInfo& info = INDUSTRY_INFO[industry_types[i]];
+        // Processing industries only make as much as they were sent, sinks use up everything
+        float made = info.rate;
+        if (info.accepts != NO_CARGO) made = info.produces == NO_CARGO ? industry_input[i] : std::min(industry_input[i], info.rate);
+        if (info.accepts != NO_CARGO) industry_input[i] -= made;
+        if (info.produces == NO_CARGO) {
+            industry_shipped[i] = 0.0f;
+            continue;
+        }
+
+        float& output = industry_output[i];
+        output = std::min(output + made, ECONOMY_MAX_STOCK);
+        const float shipped = industry_links[i] >= 0 ? std::min(output, ECONOMY_LINK_CAPACITY) : 0.0f;
+        output -= shipped;
+        industry_shipped[i] = shipped;
+        income += shipped * CARGO_INFO[info.produces].price * link_distances[i];
+        delivered += shipped;
+    }
+    batch_income[begin / ECONOMY_BATCH_SIZE] = income;
+    batch_delivered[begin / ECONOMY_BATCH_SIZE] = delivered;
+}
+
+void Economy::deliver(const size_t begin, const size_t end) {
+    const size_t industry_count = industry_types.size();
+    for (size_t d = begin; d < end; d++) {
+        float received = 0.0f;
+        for (uint32_t s = incoming_offsets[d]; s < incoming_offsets[d + 1]; s++) {
+            received += industry_shipped[incoming_sources[s]];
+        }
+        if (d < industry_count) industry_input[d] = std::min(industry_input[d] + received, ECONOMY_MAX_STOCK);
+        else town_supplied[d - industry_count] += received;
+    }
+}
+
+void Economy::grow_towns(const size_t begin, const size_t end) {
+    for (size_t t = begin; t < end; t++) {
+        // A town needs a unit of cargo per 20 people a month, and grows by up to 2% with it
+        const float needed = town_population[t] / 20.0f;
+        const float satisfaction = std::min(town_supplied[t] / needed, 1.0f);
+        town_population[t] = std::max(town_population[t] * (1.0f + 0.02f * (satisfaction - 0.5f)), 50.0f);
+        town_supplied[t] = 0.0f;
+    }
+}
+
+void Economy::tick(JobPool& pool) {
+    const size_t industry_count = industry_types.size();
+    const size_t batches = (industry_count + ECONOMY_BATCH_SIZE - 1) / ECONOMY_BATCH_SIZE;
+    batch_income.assign(batches, 0.0);
+    batch_delivered.assign(batches, 0.0);
+
+    pool.parallel_for(industry_count, ECONOMY_BATCH_SIZE, [this](const size_t begin, const size_t end) {
+        produce(begin, end);
+    });
+    pool.parallel_for(get_destination_count(), ECONOMY_BATCH_SIZE, [this](const size_t begin, const size_t end) {
+        deliver(begin, end);
+    });
+    for (size_t b = 0; b < batches; b++) {
+        money += batch_income[b];
+        income_this_month += batch_income[b];
+        delivered_this_month += batch_delivered[b];
+    }
+
+    day++;
+    if (day % ECONOMY_DAYS_PER_MONTH == 0) {
+        pool.parallel_for(town_tiles.size(), ECONOMY_BATCH_SIZE, [this](const size_t begin, const size_t end) {
+            grow_towns(begin, end);
+        });
+        income_last_month = income_this_month;
+        delivered_last_month = delivered_this_month;
+        income_this_month = delivered_this_month = 0.0;
+    }
+}
+
+EconomyStats Economy::get_stats() const {
+    EconomyStats stats;
+    stats.day = day;
+    stats.money = money;
+    stats.income_last_month = income_last_month;
+    stats.delivered_last_month = delivered_last_month;
+    for (const float population : town_population) stats.population += static_cast<long long>(population);
+    stats.industries = static_cast<int>(industry_types.size());
+    stats.towns = static_cast<int>(town_tiles.size());
+    stats.links = static_cast<int>(incoming_sources.size());
+    return stats;
+}
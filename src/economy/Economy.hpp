@@ -0,0 +1,134 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_ECONOMY_HPP
+#define BUSINESS_GAME_ECONOMY_HPP
+#include <cstdint>
+#include <vector>
+#include "sim/JobPool.hpp"
+#include "voxel/VoxelGrid.hpp"
+
+#define ECONOMY_DAYS_PER_MONTH 30
+#define ECONOMY_MONTHS_PER_YEAR 12
+#define ECONOMY_BATCH_SIZE 1024        // industries or destinations per job
+#define ECONOMY_MAX_LINK_DISTANCE 96   // in tiles, cargo isn't shipped further than this
+#define ECONOMY_LINK_CAPACITY 40.0f    // cargo a link moves per day
+#define ECONOMY_MAX_STOCK 1000.0f      // cargo waiting at an industry, anything over this is lost
+
+enum CargoType : uint8_t {
+    COAL_CARGO = 0,
+    WOOD_CARGO,
+    GOODS_CARGO,
+    FOOD_CARGO,
+    CARGO_TYPE_COUNT,
+    NO_CARGO = 255,
+};
+
+enum IndustryType : uint8_t {
+    COAL_MINE = 0,
+    POWER_STATION,
+    FOREST,
+    SAWMILL,
+    FARM,
+    INDUSTRY_TYPE_COUNT,
+};
+
+struct CargoInfo {
+    const char* name;
+    float price; // per unit, per tile it travels
+};
+
+struct IndustryInfo {
+    const char* name;
+    CargoType produces;
+    CargoType accepts;
+    // Produced per day, or processed per day if it accepts something.
+    // Sinks (accept something, produce nothing) use up all they are sent, whatever their rate.
+    float rate;
+};
+
+inline constexpr CargoInfo CARGO_INFO[CARGO_TYPE_COUNT] = {
+    {"coal", 0.06f},
+    {"wood", 0.05f},
+    {"goods", 0.12f},
+    {"food", 0.09f},
+};
+
+inline constexpr IndustryInfo INDUSTRY_INFO[INDUSTRY_TYPE_COUNT] = {
+    {"coal mine", COAL_CARGO, NO_CARGO, 12.0f},
+    {"power station", NO_CARGO, COAL_CARGO, 0.0f}, // a sink
+    {"forest", WOOD_CARGO, NO_CARGO, 10.0f},
+    {"sawmill", GOODS_CARGO, WOOD_CARGO, 16.0f},
+    {"farm", FOOD_CARGO, NO_CARGO, 8.0f},
+};
+
+struct EconomyStats {
+    uint32_t day = 0;
+    double money = 0.0;
+    double income_last_month = 0.0;
+    double delivered_last_month = 0.0; // units of cargo
+    long long population = 0;
+    int industries = 0;
+    int towns = 0;
+    int links = 0;
+};
+
+// Industries, towns and the cargo between them.
+// Everything is a struct of arrays. Every industry ships what it produces over one
+// link, to the closest industry or town that accepts it. A day is three passes,
+// each split into batches over a JobPool:
+//   1. every industry processes its input, produces and fills its shipment,
+//   2. every destination adds up the shipments coming to it, in a fixed order,
+//   3. at the end of a month, every town grows or shrinks with what it was sent.
+// A pass only writes to the industry or destination it is looking at, and sums over
+// batches are added up in batch order, so the result doesn't depend on the thread count.
+class Economy {
+public:
+    // Industries
+    std::vector<IndustryType> industry_types;
+    std::vector<Int2> industry_tiles;
+    std::vector<float> industry_input;  // waiting to be processed
+    std::vector<float> industry_output; // waiting to be shipped
+    std::vector<float> industry_shipped; // today
+    std::vector<int> industry_links;     // destination, -1 if nothing nearby accepts its cargo
+    std::vector<float> link_distances;   // per industry, in tiles
+
+    // Towns, accept food and goods
+    std::vector<Int2> town_tiles;
+    std::vector<float> town_population;
+    std::vector<float> town_supplied; // this month
+
+    // Scatters towns and industries over a map of size tiles, then links them
+    void generate(Int2 size, int town_count, int industry_count, uint32_t seed, JobPool& pool);
+    void clear();
+    // Links every industry to its closest destination. Call after adding industries or towns.
+    void build_links(JobPool& pool);
+
+    // One day
+    void tick(JobPool& pool);
+
+    EconomyStats get_stats() const;
+    // Destinations are the industries, then the towns
+    size_t get_destination_count() const { return industry_types.size() + town_tiles.size(); }
+
+private:
+    uint32_t day = 0;
+    double money = 0.0;
+    double income_this_month = 0.0, income_last_month = 0.0;
+    double delivered_this_month = 0.0, delivered_last_month = 0.0;
+
+    // Incoming links of every destination, sorted by industry
+    std::vector<uint32_t> incoming_offsets; // destination d has incoming_sources[offsets[d] .. offsets[d + 1])
+    std::vector<uint32_t> incoming_sources;
+    // per batch of pass 1
+    std::vector<double> batch_income;
+    std::vector<double> batch_delivered;
+
+    void produce(size_t begin, size_t end);
+    void deliver(size_t begin, size_t end);
+    void grow_towns(size_t begin, size_t end);
+};
+
+
+#endif //BUSINESS_GAME_ECONOMY_HPP
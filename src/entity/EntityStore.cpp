@@ -0,0 +1,105 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "entity/EntityStore.hpp"
+
+EntityId EntityStore::create(const EntityKind kind, const Vector3 position, const int model) {
+    uint32_t slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(generations.size());
+        generations.emplace_back(0);
+        slot_index.emplace_back(0);
+    }
+
+    const EntityId id = {slot, generations[slot]};
+    slot_index[slot] = static_cast<uint32_t>(ids.size());
+    ids.emplace_back(id);
+    kinds.emplace_back(kind);
+    positions.emplace_back(position);
+    velocities.emplace_back(Vector2{0.0f, 0.0f});
+    headings.emplace_back(0.0f);
+    models.emplace_back(model);
+    routes.emplace_back(-1);
+    route_segments.emplace_back(0);
+    route_offsets.emplace_back(0.0f);
+    speeds.emplace_back(0.0f);
+    return id;
+}
+
+bool EntityStore::destroy(const EntityId id) {
+    const int index = get_index(id);
+    if (index < 0) return false;
+
+    // Move the last entity into the hole
+    const size_t last = ids.size() - 1;
+    if (static_cast<size_t>(index) != last) {
+        ids[index] = ids[last];
+        kinds[index] = kinds[last];
+        positions[index] = positions[last];
+        velocities[index] = velocities[last];
+        headings[index] = headings[last];
+        models[index] = models[last];
+        routes[index] = routes[last];
+        route_segments[index] = route_segments[last];
+        route_offsets[index] = route_offsets[last];
+        speeds[index] = speeds[last];
+        slot_index[ids[index].slot] = index;
+    }
+    ids.pop_back();
+    kinds.pop_back();
+    positions.pop_back();
+    velocities.pop_back();
+    headings.pop_back();
+    models.pop_back();
+    routes.pop_back();
+    route_segments.pop_back();
+    route_offsets.pop_back();
+    speeds.pop_back();
+
+    generations[id.slot]++;
+    free_slots.emplace_back(id.slot);
+    return true;
+}
+
+void EntityStore::clear() {
+    for (const EntityId& id : ids) {
+        generations[id.slot]++;
+        free_slots.emplace_back(id.slot);
+    }
+    ids.clear();
+    kinds.clear();
+    positions.clear();
+    velocities.clear();
+    headings.clear();
+    models.clear();
+    routes.clear();
+    route_segments.clear();
+    route_offsets.clear();
+    speeds.clear();
+}
+
+void EntityStore::reserve(const size_t count) {
+    ids.reserve(count);
+    kinds.reserve(count);
+    positions.reserve(count);
+    velocities.reserve(count);
+    headings.reserve(count);
+    models.reserve(count);
+    routes.reserve(count);
+    route_segments.reserve(count);
+    route_offsets.reserve(count);
+    speeds.reserve(count);
+}
+
+bool EntityStore::is_alive(const EntityId id) const {
+    return id.slot < generations.size() && generations[id.slot] == id.generation;
+}
+
+int EntityStore::get_index(const EntityId id) const {
+    if (!is_alive(id)) return -1;
+    return static_cast<int>(slot_index[id.slot]);
+}
@@ -0,0 +1,68 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_ENTITYSTORE_HPP
+#define BUSINESS_GAME_ENTITYSTORE_HPP
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+enum EntityKind : uint8_t {
+    VEHICLE_ENTITY = 0,
+    BUILDING_ENTITY = 1,
+};
+
+// Handle to an entity. The generation tells apart entities that reused the same slot,
+// so a handle to a destroyed entity never points at a new one.
+struct EntityId {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityId& other) const noexcept {
+        return slot == other.slot && generation == other.generation;
+    }
+};
+
+// Every vehicle and building, stored as a struct of arrays.
+// The component arrays are dense: entity i of a batch is index i of every array,
+// and destroying an entity moves the last one into its place. Systems loop over
+// the arrays they need directly, there is no per-entity object or virtual call.
+// Positions are in map space (x, y, z up), in voxels.
+class EntityStore {
+public:
+    // Components, all of size()
+    std::vector<EntityId> ids;
+    std::vector<EntityKind> kinds;
+    std::vector<Vector3> positions;
+    std::vector<Vector2> velocities; // voxels per second, on the map plane
+    std::vector<float> headings;     // radians, 0 faces +x
+    std::vector<int> models;         // index into the model table of whoever draws them, -1 for none
+    // Track following (see VehicleSystem.hpp), vehicles with a route ignore their velocity
+    std::vector<int> routes;            // index into the RouteTable, -1 for none
+    std::vector<uint32_t> route_segments;
+    std::vector<float> route_offsets;   // along the current segment
+    std::vector<float> speeds;          // voxels per second, along the route
+
+    EntityId create(EntityKind kind, Vector3 position, int model = -1);
+    // Returns false if the entity was already destroyed
+    bool destroy(EntityId id);
+    void clear();
+    void reserve(size_t count);
+
+    bool is_alive(EntityId id) const;
+    // Index of the entity in the component arrays, -1 if it is not alive.
+    // Only valid until the next destroy().
+    int get_index(EntityId id) const;
+    size_t size() const { return ids.size(); }
+    // Highest slot + 1, for tables indexed by EntityId::slot
+    size_t get_slot_count() const { return generations.size(); }
+
+private:
+    std::vector<uint32_t> generations; // per slot
+    std::vector<uint32_t> slot_index;  // per slot, index in the component arrays
+    std::vector<uint32_t> free_slots;
+};
+
+
+#endif //BUSINESS_GAME_ENTITYSTORE_HPP
@@ -0,0 +1,93 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "game/MemoryTracker.hpp"
+
+#include <raylib.h>
+
+static constexpr const char* TAG_NAMES[MEMORY_TAG_COUNT] = {
+    "chunks", "chunk summaries", "mesh data", "mesher scratch", "lights",
+    "GPU meshes", "shadow maps", "light textures",
+};
+
+static void raiseTo(std::atomic<size_t>& peak, const size_t bytes) {
+    size_t current = peak.load(std::memory_order_relaxed);
+    while (bytes > current && !peak.compare_exchange_weak(current, bytes, std::memory_order_relaxed)) {}
+}
+
+static double toMB(const size_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+void MemoryTracker::allocate(const MemoryTag tag, const size_t bytes) {
+    resize(tag, 0, bytes);
+}
+
+void MemoryTracker::free(const MemoryTag tag, const size_t bytes) {
+    resize(tag, bytes, 0);
+}
+
+void MemoryTracker::resize(const MemoryTag tag, const size_t old_bytes, const size_t new_bytes) {
+    if (new_bytes == old_bytes) return;
+    Counter& counter = counters[static_cast<int>(tag)];
+    if (old_bytes == 0) counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    if (new_bytes == 0) counter.frees.fetch_add(1, std::memory_order_relaxed);
+    if (new_bytes < old_bytes) {
+        counter.bytes.fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+        return;
+    }
+    const size_t now = counter.bytes.fetch_add(new_bytes - old_bytes, std::memory_order_relaxed) + new_bytes - old_bytes;
+    update_peaks(counter, now, is_gpu(tag));
+}
+
+void MemoryTracker::set(const MemoryTag tag, const size_t bytes) {
+    Counter& counter = counters[static_cast<int>(tag)];
+    if (counter.bytes.exchange(bytes, std::memory_order_relaxed) == bytes) return;
+    update_peaks(counter, bytes, is_gpu(tag));
+}
+
+void MemoryTracker::update_peaks(Counter& counter, const size_t bytes, const bool gpu) {
+    raiseTo(counter.peak, bytes);
+    raiseTo(peaks[gpu], get_total_bytes(gpu));
+}
+
+MemoryTagStats MemoryTracker::get_stats(const MemoryTag tag) const {
+    const Counter& counter = counters[static_cast<int>(tag)];
+    return MemoryTagStats{
+        counter.bytes.load(std::memory_order_relaxed),
+        counter.peak.load(std::memory_order_relaxed),
+        counter.allocations.load(std::memory_order_relaxed),
+        counter.frees.load(std::memory_order_relaxed),
+    };
+}
+
+size_t MemoryTracker::get_total_bytes(const bool gpu) const {
+    size_t bytes = 0;
+    for (int i = 0; i < MEMORY_TAG_COUNT; i++) {
+        if (is_gpu(static_cast<MemoryTag>(i)) == gpu) bytes += counters[i].bytes.load(std::memory_order_relaxed);
+    }
+    return bytes;
+}
+
+size_t MemoryTracker::get_total_peak(const bool gpu) const {
+    return peaks[gpu].load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::dump() const {
+    TraceLog(LOG_INFO, "[Memory] %-16s %10s %10s %10s %10s", "tag", "MB", "peak MB", "allocs", "frees");
+    for (int i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const auto tag = static_cast<MemoryTag>(i);
+        const MemoryTagStats stats = get_stats(tag);
+        TraceLog(LOG_INFO, "[Memory] %-16s %10.2f %10.2f %10lld %10lld", get_tag_name(tag),
+            toMB(stats.bytes), toMB(stats.peak),
+            static_cast<long long>(stats.allocations), static_cast<long long>(stats.frees));
+    }
+    TraceLog(LOG_INFO, "[Memory] RAM %.2f MB (peak %.2f), GPU %.2f MB (peak %.2f)",
+        toMB(get_total_bytes(false)), toMB(get_total_peak(false)),
+        toMB(get_total_bytes(true)), toMB(get_total_peak(true)));
+}
+
+const char* MemoryTracker::get_tag_name(const MemoryTag tag) {
+    return TAG_NAMES[static_cast<int>(tag)];
+}
@@ -0,0 +1,91 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_MEMORYTRACKER_HPP
+#define BUSINESS_GAME_MEMORYTRACKER_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class MemoryTag {
+    Chunks,         // voxels of the loaded chunks, and of the edited ones kept after eviction
+    ChunkSummaries,
+    MeshData,       // CPU copies of the meshes, raylib keeps them after uploading
+    MesherScratch,  // the mesher's buffers, only while a chunk is being meshed
+    Lights,         // light lists and cluster grids on the CPU
+    // the ones below are GPU memory, estimated from the sizes of what was uploaded
+    GpuMeshes,
+    ShadowMaps,
+    LightTextures,
+    Count,
+};
+#define MEMORY_TAG_COUNT static_cast<int>(MemoryTag::Count)
+
+struct MemoryTagStats {
+    size_t bytes = 0;
+    size_t peak = 0;         // most bytes at any point since the start
+    int64_t allocations = 0;
+    int64_t frees = 0;
+};
+
+// Bytes in use per tag, for budgeting big maps. Nothing hooks malloc, the owners
+// report their allocations (and what they upload), so untagged memory isn't in here.
+// Safe to call from any thread, the mesher runs on the streamer's threads too.
+class MemoryTracker {
+public:
+    void allocate(MemoryTag tag, size_t bytes);
+    void free(MemoryTag tag, size_t bytes);
+    // For owners that only know their total. Going from or to 0 counts as an allocation or
+    // a free, anything else only changes the bytes.
+    void resize(MemoryTag tag, size_t old_bytes, size_t new_bytes);
+    // For memory that is measured every frame instead of counted, like the lights
+    void set(MemoryTag tag, size_t bytes);
+
+    MemoryTagStats get_stats(MemoryTag tag) const;
+    // Of all the CPU (or GPU) tags
+    size_t get_total_bytes(bool gpu) const;
+    size_t get_total_peak(bool gpu) const;
+    // Logs every tag
+    void dump() const;
+
+    static const char* get_tag_name(MemoryTag tag);
+    static bool is_gpu(MemoryTag tag) { return tag >= MemoryTag::GpuMeshes; }
+
+private:
+    struct Counter {
+        std::atomic<size_t> bytes{0};
+        std::atomic<size_t> peak{0};
+        std::atomic<int64_t> allocations{0};
+        std::atomic<int64_t> frees{0};
+    };
+    std::array<Counter, MEMORY_TAG_COUNT> counters;
+    std::atomic<size_t> peaks[2]{}; // of the totals, CPU and GPU
+
+    void update_peaks(Counter& counter, size_t bytes, bool gpu);
+};
+
+// Memory held until the end of the scope, freed from the tracker in the destructor.
+// Counts as one allocation however many times it grows.
+class ScopedAllocation {
+public:
+    ScopedAllocation(MemoryTracker& tracker, const MemoryTag tag) : tracker(tracker), tag(tag) {}
+    ~ScopedAllocation() { tracker.free(tag, bytes); }
+
+    ScopedAllocation(const ScopedAllocation&) = delete;
+    ScopedAllocation& operator=(const ScopedAllocation&) = delete;
+
+    void add(const size_t bytes) {
+        tracker.resize(tag, this->bytes, this->bytes + bytes);
+        this->bytes += bytes;
+    }
+
+private:
+    MemoryTracker& tracker;
+    MemoryTag tag;
+    size_t bytes = 0;
+};
+
+
+#endif //BUSINESS_GAME_MEMORYTRACKER_HPP
@@ -4,16 +4,21 @@
 
 #include "main.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <stdexcept>
-#include <regex>
+#include <random>
+#include <cctype>
+#include <cstdlib>
 
 #include "raylib-cpp.hpp"
 #include "voxel/VoxelMesher.hpp"
 #include "voxel/SingleChunkGrid.hpp"
+#include "render/Frustum.hpp"
+#include "bench/Bench.hpp"
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -22,8 +27,7 @@
 #define GLSL_VERSION 330
 
 void global::init() {
-    SetConfigFlags(FLAG_MSAA_4X_HINT);  // Enable Multi Sampling Anti Aliasing 4x (if available)
-    raylib::Window::Init(1600, 900, "business game");
+    render_backend->open(1600, 900, "business game");
     camera = {
         {
             { 10.0f, 5.0f, 0.0f },
@@ -34,30 +38,69 @@ void global::init() {
         },
     };
 
-    voxel_shader = loadAndPatchShader("../resources/shaders/lighting", 2);
-    voxel_shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(voxel_shader, "viewPos");
+    voxel_shader = loadShader("../resources/shaders/lighting");
+    voxel_shader.locs[SHADER_LOC_VECTOR_VIEW] = render_backend->get_shader_location(voxel_shader, "viewPos");
 
     // Ambient light level (some basic lighting)
-    int ambientLoc = GetShaderLocation(voxel_shader, "ambient");
-    SetShaderValue(voxel_shader, ambientLoc, ambient, SHADER_UNIFORM_VEC4);
+    int ambientLoc = render_backend->get_shader_location(voxel_shader, "ambient");
+    render_backend->set_shader_value(voxel_shader, ambientLoc, ambient, SHADER_UNIFORM_VEC4);
 
-    // Shadow map resolution
+    // Depth only shader for the shadow passes
+    depth_shader = loadShader("../resources/shaders/depth");
+    depth_material = render_backend->load_material_default();
+    depth_material.shader = depth_shader;
+
+    // Shadow atlas, one tile per shadow casting light
+    shadow_atlas.load(*render_backend, SHADOWMAP_RESOLUTION, SHADOW_ATLAS_TILES);
     auto res = SHADOWMAP_RESOLUTION;
-    SetShaderValue(voxel_shader, GetShaderLocation(voxel_shader, "shadowMapResolution"), &res, SHADER_UNIFORM_INT);
+    render_backend->set_shader_value(voxel_shader, render_backend->get_shader_location(voxel_shader, "shadowMapResolution"), &res, SHADER_UNIFORM_INT);
+    auto tiles = shadow_atlas.get_tiles_per_side();
+    render_backend->set_shader_value(voxel_shader, render_backend->get_shader_location(voxel_shader, "shadowAtlasTiles"), &tiles, SHADER_UNIFORM_INT);
+    shadow_atlas_loc = render_backend->get_shader_location(voxel_shader, "shadowAtlas");
+    light_vp_loc = render_backend->get_shader_location(voxel_shader, "lightVP");
 
     // Create lights
-    lights = std::vector<Light>();
+    light_manager.load(*render_backend, voxel_shader, &shadow_atlas);
     auto sun_pos = Vector3Scale(Vector3{32.0, 8.0, 32.0}, voxel_scale);
     auto sun_tgt = Vector3Scale(Vector3{48.0, 0.0, 48.0}, voxel_scale);
-    camera_light_id = Light::create(DIRECTIONAL_LIGHT, camera.position, camera.target, WHITE, voxel_shader);
-    sun_light_id = Light::create(DIRECTIONAL_LIGHT, sun_pos, sun_tgt, WHITE, voxel_shader);
+    camera_light_id = light_manager.create(DIRECTIONAL_LIGHT, camera.position, camera.target, WHITE);
+    sun_light_id = light_manager.create(DIRECTIONAL_LIGHT, sun_pos, sun_tgt, WHITE);
+    sun_offset = Vector3Subtract(sun_pos, sun_tgt);
+    // The sun shadows everything on screen, keep it fresher than the rest
+    light_manager.lights[sun_light_id].shadow_importance = 2.0f;
 
     // Voxels
     voxel_grids = std::vector<VoxelGrid*>();
 
-    game_map = new VoxelMap(128, 128);
+    game_map = stream_world ? new VoxelMap() : new VoxelMap(128, 128);
+    game_map->spatial_index = &spatial_index;
     voxel_grids.emplace_back(game_map);
 
+    // Street lamps scattered over the terrain
+    light_clusters.load(*render_backend, voxel_shader);
+    std::mt19937 rng(42);
+    // (the streaming map starts empty, there is nothing to put them on yet)
+    if (!stream_world) {
+        std::uniform_int_distribution<int> lamp_x(0, game_map->get_size().x - 1);
+        std::uniform_int_distribution<int> lamp_y(0, game_map->get_size().y - 1);
+        std::uniform_int_distribution<int> lamp_warmth(0, 80);
+        for (int i = 0; i < 256; i++) {
+            Int2 column = {lamp_x(rng), lamp_y(rng)};
+            int top = std::max(game_map->get_surface_height(column) - 1, 0);
+
+            auto lamp_pos = game_map->get_voxel_position(Int3(column.x, column.y, top + 2));
+            auto warmth = static_cast<unsigned char>(lamp_warmth(rng));
+            auto lamp_colour = Color{255, static_cast<unsigned char>(200 + warmth / 2), static_cast<unsigned char>(120 + warmth), 255};
+            int lamp = light_manager.create(POINT_LIGHT, Vector3Scale(lamp_pos, voxel_scale), Vector3{}, lamp_colour);
+            if (lamp < 0) break;
+            light_manager.lights[lamp].radius = 1.2f;
+            light_manager.lights[lamp].intensity = 1.5f;
+        }
+    }
+
+    pathfinder = new TerrainPathfinder(game_map);
+    network = new TransportNetwork(game_map);
+
     auto single_chunk_grid = new SingleChunkGrid(game_map->voxel_colours);
     *single_chunk_grid->get_voxel(Int3(0.0,0.0,0.0)) = 3;
     *single_chunk_grid->get_voxel(Int3(1.0,0.0,0.0)) = 3;
@@ -66,7 +109,72 @@ void global::init() {
     single_chunk_grid->transform.translation = Vector3(-2.0f, 6.0f, -2.0f);
     single_chunk_grid->transform.scale = Vector3(2.0f, 2.0f, 2.0f);
     single_chunk_grid->was_updated = true;
+    single_chunk_grid->spatial_index = &spatial_index;
     voxel_grids.emplace_back(single_chunk_grid);
+
+    // Entities: a car and a house model, some of each on the terrain
+    auto car = new SingleChunkGrid(game_map->voxel_colours);
+    for (int x = 0; x < 3; x++) {
+        for (int y = 0; y < 2; y++) *car->get_voxel(Int3(x, y, 0)) = 3;
+    }
+    *car->get_voxel(Int3(1, 0, 1)) = 1;
+    *car->get_voxel(Int3(1, 1, 1)) = 1;
+    car->transform.translation = Vector3(-1.5f, 0.0f, -1.0f); // turn around its centre
+    auto house = new SingleChunkGrid(game_map->voxel_colours);
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            for (int z = 0; z < 4; z++) *house->get_voxel(Int3(x, y, z)) = z < 3 ? 1 : 2;
+        }
+    }
+    house->transform.translation = Vector3(-2.0f, 0.0f, -2.0f);
+    for (VoxelGrid* model : {static_cast<VoxelGrid*>(car), static_cast<VoxelGrid*>(house)}) {
+        model->update_models();
+        entity_models.emplace_back(model);
+    }
+
+    // The economy and vehicles live on a fixed size map
+    if (!stream_world) {
+        std::uniform_real_distribution<float> map_x(0.0f, static_cast<float>(game_map->get_size().x));
+        std::uniform_real_distribution<float> map_y(0.0f, static_cast<float>(game_map->get_size().y));
+        std::uniform_real_distribution<float> angle(0.0f, 2.0f * PI);
+        std::uniform_real_distribution<float> speed(2.0f, 6.0f);
+        // A house on every town and industry of the economy
+        simulation.set_terrain(*game_map);
+        simulation.generate_economy(8, 48, 42);
+        for (const std::vector<Int2>* sites : {&simulation.economy.town_tiles, &simulation.economy.industry_tiles}) {
+            for (const Int2 tile : *sites) {
+                const Vector3 position = {static_cast<float>(tile.x) + 0.5f, static_cast<float>(tile.y) + 0.5f, 0.0f};
+                simulation.entities.create(BUILDING_ENTITY, position, 1);
+            }
+        }
+        // Routes between random tiles, for half of the vehicles to drive around on
+        pathfinder->update();
+        std::uniform_int_distribution<int> tile_x(0, game_map->get_size().x - 1);
+        std::uniform_int_distribution<int> tile_y(0, game_map->get_size().y - 1);
+        for (int i = 0; i < 64 && simulation.routes.routes.size() < 16; i++) {
+            const Int2 from = {tile_x(rng), tile_y(rng)}, to = {tile_x(rng), tile_y(rng)};
+            simulation.routes.add(pathfinder->find_path(from, to));
+        }
+        for (int i = 0; i < 200; i++) {
+            EntityId vehicle = simulation.entities.create(VEHICLE_ENTITY, Vector3{map_x(rng), map_y(rng), 0.0f}, 0);
+            const int index = simulation.entities.get_index(vehicle);
+            const float a = angle(rng), v = speed(rng);
+            simulation.entities.velocities[index] = Vector2{cosf(a) * v, sinf(a) * v};
+            simulation.entities.headings[index] = a;
+            if (i % 2 == 0 && !simulation.routes.routes.empty()) {
+                const int route = i / 2 % static_cast<int>(simulation.routes.routes.size());
+                simulation.entities.routes[index] = route;
+                simulation.entities.route_segments[index] = rng() % simulation.routes.routes[route].points.size();
+                simulation.entities.speeds[index] = v;
+            }
+        }
+        // Buildings sit on the ground from the first tick
+        for (Vector3& position : simulation.entities.positions) {
+            position.z = static_cast<float>(game_map->get_surface_height({static_cast<int>(position.x), static_cast<int>(position.y)}));
+        }
+    }
+
+    simulation.start();
 }
 
 void global::shutdown() {
@@ -74,7 +182,11 @@ void global::shutdown() {
     //  figure out how to call it without the error
     // UnloadShader(shader);
 
-    raylib::Window::Close();
+    simulation.stop();
+    shadow_atlas.unload();
+    light_manager.unload();
+    light_clusters.unload();
+    render_backend->close();
 }
 
 void global::updateCamera() {
@@ -148,14 +260,27 @@ void global::updateCamera() {
 
     // --- Shader Update ---
     float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
-    SetShaderValue(voxel_shader, voxel_shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+    render_backend->set_shader_value(voxel_shader, voxel_shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
 }
 
 void global::updateLights() {
+    auto& lights = light_manager.lights;
+
     // Light Controls
     if (IsKeyReleased(KEY_Y)) move_camera_light = !move_camera_light;
     if (IsKeyReleased(KEY_U)) lights[sun_light_id].enabled = !lights[sun_light_id].enabled;
     if (IsKeyReleased(KEY_I)) lights[camera_light_id].enabled = !lights[camera_light_id].enabled;
+    if (IsKeyReleased(KEY_L)) {
+        point_lights_enabled = !point_lights_enabled;
+        for (Light& light : lights) {
+            if (light.type == POINT_LIGHT) light.enabled = point_lights_enabled;
+        }
+    }
+
+    // Sun, orbiting its target as the simulation says
+    if (IsKeyReleased(KEY_N)) simulation.sun_cycle = !simulation.sun_cycle;
+    lights[sun_light_id].position = Vector3Add(lights[sun_light_id].target,
+        Vector3RotateByAxisAngle(sun_offset, Vector3{0.0f, 1.0f, 0.0f}, sim_frame->sun_angle));
 
     // Camera Light
     if (move_camera_light) {
@@ -163,240 +288,256 @@ void global::updateLights() {
         lights[camera_light_id].target = camera.target;
     }
 
+    // Hand-tuned shadow frustum, only used when fit_shadows is off
+    if (IsKeyReleased(KEY_T)) fit_shadows = !fit_shadows;
     if (IsKeyPressed(KEY_O)) lights[camera_light_id].light_camera.fovy += 1.0f;
     if (IsKeyPressed(KEY_P)) lights[camera_light_id].light_camera.fovy -= 1.0f;
 
+    // Shadow maps rendered per frame
+    if (IsKeyPressed(KEY_LEFT_BRACKET) && shadow_scheduler.max_updates_per_frame > 1) shadow_scheduler.max_updates_per_frame--;
+    if (IsKeyPressed(KEY_RIGHT_BRACKET)) shadow_scheduler.max_updates_per_frame++;
+
     // Update
+    const BoundingBox scene_bounds = spatial_index.get_bounds();
     for (Light &light : lights) {
-        light.update(voxel_shader);
+        light.update();
+        if (!fit_shadows || light.shadow_slot < 0) continue;
+
+        // Whatever lies between the light and the visible chunks, however long its shadow is
+        Frustum casters;
+        caster_bounds.clear();
+        if (light.get_caster_frustum(visible_bounds, scene_bounds, casters)) {
+            spatial_index.query_frustum(casters, spatial_results);
+            for (const SpatialItem& item : spatial_results) {
+                if (!item.model->evicted) caster_bounds.emplace_back(item.model->world_bounds);
+            }
+        }
+        light.fit_shadow(visible_bounds, caster_bounds, SHADOWMAP_RESOLUTION);
     }
+    // Only the lights that changed are sent to the GPU
+    light_manager.upload();
+
+    // Bin the point lights into the clusters of this frame's camera
+    light_clusters.update(lights, camera, render_backend->get_render_width(), render_backend->get_render_height());
 }
 
 void global::updateVoxelMesh() {
+    if (game_map->is_streaming()) game_map->stream_around(camera.position);
+    scene_revision = 0;
     for (VoxelGrid* grid : voxel_grids) {
         grid->update_models();
+        scene_revision += grid->revision + grid->get_transform_revision();
     }
 }
 
-void global::mainLoop() {
-    // Update
-    updateCamera();
-    updateVoxelMesh();
-    updateLights();
+void global::updateVisibility() {
+    const float aspect = static_cast<float>(render_backend->get_render_width()) / static_cast<float>(render_backend->get_render_height());
+    const Frustum frustum = Frustum::from_camera(camera, aspect);
+
+    visible_models.clear();
+    visible_bounds.clear();
+    spatial_index.query_frustum(frustum, spatial_results);
+    for (const SpatialItem& item : spatial_results) {
+        ModelInfo* model_info = item.model;
+        const Matrix& m = model_info->world_matrix;
+        if (!isInRenderDistance(Vector3{m.m12, m.m13, m.m14})) continue;
+
+        // Keeps it loaded, or has it rebuilt next frame if it was evicted
+        model_info->last_used = frame;
+        if (model_info->evicted) continue;
+        visible_models.emplace_back(model_info);
+        visible_bounds.emplace_back(model_info->world_bounds);
+    }
 
-    Matrix light_view = {};
-    Matrix light_proj = {};
-
-    // PASS 1: Render all objects into the shadow map render texture
-    for (Light& light : lights) {
-        BeginTextureMode(*light.shadow_map); {
-            ClearBackground(WHITE);
-            if (light.enabled) {
-                BeginMode3D(light.light_camera); {
-                    light_view = rlGetMatrixModelview();
-                    light_proj = rlGetMatrixProjection();
-                    drawVoxelScene();
-                }
-                EndMode3D();
-            }
+    if (IsKeyReleased(KEY_K)) occlusion_culling = !occlusion_culling;
+    // Halve or double the memory budget of the chunk models
+    if (IsKeyPressed(KEY_MINUS) && game_map->model_budget > 1024 * 1024) game_map->model_budget /= 2;
+    if (IsKeyPressed(KEY_EQUAL)) game_map->model_budget *= 2;
+    if (!occlusion_culling) return;
+
+    // Occlusion culling: the visible chunks' solid parts are drawn into the
+    // software depth buffer, then every visible chunk is tested against it
+    occlusion_culler.begin(MatrixMultiply(GetCameraMatrix(camera), getCameraProjection(camera, aspect)));
+    for (ModelInfo* model_info : visible_models) {
+        for (const BoundingBox& occluder : model_info->occluders) {
+            occlusion_culler.add_occluder(occluder, model_info->world_matrix);
         }
-        EndTextureMode();
-        // Update lightVP
-        light.light_view_proj = MatrixMultiply(light_view, light_proj);
     }
-    // PASS 2: Drawing
-    BeginDrawing(); {
-        ClearBackground(RAYWHITE);
-        rlEnableShader(voxel_shader.id);
-        for (Light& light : lights) {
-            rlActiveTextureSlot(light.texture_loc);
-            rlEnableTexture(light.shadow_map->depth.id);
-            rlSetUniform(light.shadow_map_loc, &light.texture_loc, SHADER_UNIFORM_INT, 1);
-            SetShaderValueMatrix(voxel_shader, light.vp_loc, light.light_view_proj);
-        }
-        BeginMode3D(camera); {
-            drawVoxelScene();
-
-            // Shader Mode is only necessary for immediate draw calls
-            BeginShaderMode(voxel_shader); {
-                // Test Cube
-                DrawCube(Vector3{0.0, 0.0, 0.0}, 1.0, 1.0, 1.0, ORANGE);
-            }
-            EndShaderMode();
+    size_t kept = 0;
+    for (size_t i = 0; i < visible_models.size(); i++) {
+        if (!occlusion_culler.is_visible(visible_bounds[i])) continue;
+        visible_models[kept] = visible_models[i];
+        visible_bounds[kept] = visible_bounds[i];
+        kept++;
+    }
+    visible_models.resize(kept);
+    visible_bounds.resize(kept);
+}
 
-            // Draw spheres to show where the lights are
-            for (Light& light : lights) {
-                if (light.enabled) DrawSphereEx(light.position, 0.2f, 8, 8, light.color);
-                else DrawSphereWires(light.position, 0.2f, 8, 8, ColorAlpha(light.color, 0.3f));
-            }
+void global::updatePicking() {
+    Ray mouse_ray;
+    if (render_backend->is_headless()) {
+        // no mouse without a window, pick whatever is in the middle of the screen
+        const int width = render_backend->get_render_width(), height = render_backend->get_render_height();
+        const Vector2 centre = {static_cast<float>(width) / 2.0f, static_cast<float>(height) / 2.0f};
+        mouse_ray = GetScreenToWorldRayEx(centre, camera, width, height);
+    } else {
+        mouse_ray = GetScreenToWorldRay(GetMousePosition(), camera);
+    }
+    // Only the grids with a model along the ray
+    spatial_index.query_ray(mouse_ray, pick_distance, spatial_results);
+    picked_grids.clear();
+    for (const SpatialItem& item : spatial_results) {
+        if (std::find(picked_grids.begin(), picked_grids.end(), item.grid) == picked_grids.end()) {
+            picked_grids.emplace_back(item.grid);
+        }
+    }
+    hovered_voxel = raycast_voxel_grids(picked_grids, mouse_ray, pick_distance);
+
+    // Only the chunks edited since last frame are rebuilt
+    pathfinder->update();
+    if (hovered_voxel.has_value() && hovered_voxel->grid == game_map) {
+        const Int2 tile = {hovered_voxel->voxel.x, hovered_voxel->voxel.y};
+        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            path_start = tile;
+            path_preview.clear();
+        }
+        if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT) && path_start.has_value()) {
+            // Along the roads if both ends are on the same network
+            if (network->is_connected(*path_start, tile)) path_preview = network->find_route(*path_start, tile);
+            else path_preview = pathfinder->find_path(*path_start, tile);
         }
-        EndMode3D();
     }
-    EndDrawing();
+    if (IsKeyReleased(KEY_B)) network->build_road(path_preview);
+    if (IsKeyReleased(KEY_V)) network->remove_road(path_preview);
 }
 
-size_t Light::create(LightType type, Vector3 pos, Vector3 target, Color color, const Shader& shader) {
-    Light& light = global::lights.emplace_back();
-
-    light.enabled = true;
-    light.type = type == DIRECTIONAL_LIGHT ? 0 : 1;
-    light.position = pos;
-    light.target = target;
-    light.color = color;
-
-    light.id = global::next_light_id++;
-    light.enabled_loc  = GetShaderLocation(shader, TextFormat("lights[%i].enabled",  light.id));
-    light.type_loc     = GetShaderLocation(shader, TextFormat("lights[%i].type",     light.id));
-    light.position_loc = GetShaderLocation(shader, TextFormat("lights[%i].position", light.id));
-    light.target_loc   = GetShaderLocation(shader, TextFormat("lights[%i].target",   light.id));
-    light.color_loc    = GetShaderLocation(shader, TextFormat("lights[%i].color",    light.id));
-    // L.attenuationLoc = GetShaderLocation(shader, TextFormat("lights[%i].attenuation", L.id));
-    light.texture_loc = light.id + 10; // the 10 is kinda arbitrary
-    light.vp_loc = GetShaderLocation(shader, TextFormat("lightVP%i", light.id));
-    light.shadow_map_loc = GetShaderLocation(shader, TextFormat("shadowMap%i", light.id));
-
-    light.light_camera = {
-        light.position,
-        light.target,
-        { 0.0f, 1.0f, 0.0f },
-        32.0f,
-        CAMERA_ORTHOGRAPHIC
-    };
+void global::updateEntityBounds() {
+    entity_bounds.swap(last_entity_bounds);
+    entity_bounds.clear();
+    for (size_t i = 0; i < sim_frame->entity_ids.size(); i++) {
+        const int model_id = sim_frame->entity_models[i];
+        BoundingBox bounds{};
+        bool first = true;
+        if (model_id >= 0) {
+            for (const ModelInfo* model_info : entity_models[model_id]->get_models()) {
+                if (model_info == nullptr) continue;
+                const BoundingBox model_bounds = transformBoundingBox(model_info->bounds,
+                    getEntityMatrix(*sim_frame, i, *model_info));
+                bounds = first ? model_bounds : mergeBoundingBox(bounds, model_bounds);
+                first = false;
+            }
+        }
+        entity_bounds.emplace_back(sim_frame->entity_ids[i], bounds);
+    }
 
-    // Shadow Map
-    light.shadow_map = new raylib::RenderTexture2D();
-    auto fbo = rlLoadFramebuffer(); // load an empty framebuffer
-    light.shadow_map->id = fbo;
-    light.shadow_map->texture.width = SHADOWMAP_RESOLUTION;
-    light.shadow_map->texture.height = SHADOWMAP_RESOLUTION;
-    if (fbo > 0) {
-        rlEnableFramebuffer(fbo);
-
-        // Create depth texture
-        light.shadow_map->depth.id = rlLoadTextureDepth(SHADOWMAP_RESOLUTION, SHADOWMAP_RESOLUTION, false);
-        light.shadow_map->depth.width = SHADOWMAP_RESOLUTION;
-        light.shadow_map->depth.height = SHADOWMAP_RESOLUTION;
-        // light.shadow_map->depth.format = PIXELFORMAT_COMPRESSED_ETC2_RGB; // Already written by rlLoadTextureDepth
-        light.shadow_map->depth.mipmaps = 1;
-
-        // Attach depth texture to framebuffer
-        rlFramebufferAttach(fbo, light.shadow_map->depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
-
-        // Check if framebuffer is complete with attachments
-        if (rlFramebufferComplete(fbo) > 0)
-            TRACELOG(LOG_INFO, "FBO: [ID %i] Framebuffer object created successfully", fbo);
-        else
-            TRACELOG(LOG_WARNING, "FBO: [ID %i] Framebuffer object created unsuccessfully", fbo);
-
-        rlDisableFramebuffer();
-    }
-    else TraceLog(LOG_WARNING, "FBO: Shadowmap framebuffer object can not be created!");
-
-    TraceLog(LOG_DEBUG, "[Light] %zu: unit=%d locSamp=%d fbo=%u depthTex=%u pos=(%.2f,%.2f,%.2f) tgt=(%.2f,%.2f,%.2f)",
-        light.id, light.texture_loc, light.shadow_map_loc,
-        light.shadow_map->id, light.shadow_map->depth.id,
-        light.position.x, light.position.y, light.position.z,
-        light.target.x, light.target.y, light.target.z);
-
-    return global::lights.size() - 1;
+    // Snapshots keep the entities in the same order, anything that isn't where it was counts as moved
+    moved_entity_bounds.clear();
+    for (size_t i = 0; i < std::max(entity_bounds.size(), last_entity_bounds.size()); i++) {
+        const bool now = i < entity_bounds.size(), before = i < last_entity_bounds.size();
+        if (now && before && entity_bounds[i].first == last_entity_bounds[i].first
+            && Vector3Equals(entity_bounds[i].second.min, last_entity_bounds[i].second.min)
+            && Vector3Equals(entity_bounds[i].second.max, last_entity_bounds[i].second.max)) continue;
+        if (now) moved_entity_bounds.emplace_back(entity_bounds[i].second);
+        if (before) moved_entity_bounds.emplace_back(last_entity_bounds[i].second);
+    }
 }
 
-void Light::update(Shader shader) {
-    // Move light camera
-    light_camera.position = position;
-    light_camera.target = target;
-
-    // Send to shader light enabled state and type
-    int s_enabled = enabled ? 1 : 0;
-    SetShaderValue(shader, enabled_loc, &s_enabled, SHADER_UNIFORM_INT);
-    int s_type = (type == POINT_LIGHT) ? 1 : 0;
-    SetShaderValue(shader, type_loc, &s_type, SHADER_UNIFORM_INT);
+void global::updateMemoryStats() {
+    memory_tracker.set(MemoryTag::Lights, light_manager.get_cpu_bytes() + light_clusters.get_cpu_bytes());
+    memory_tracker.set(MemoryTag::LightTextures, light_manager.get_gpu_bytes() + light_clusters.get_gpu_bytes());
+    memory_tracker.set(MemoryTag::ShadowMaps, shadow_atlas.get_gpu_bytes());
 
-    // Send to shader light position values
-    float s_position[3] = {position.x, position.y, position.z};
-    SetShaderValue(shader, position_loc, s_position, SHADER_UNIFORM_VEC3);
+    if (IsKeyReleased(KEY_M)) memory_tracker.dump();
+}
 
-    // Send to shader light target position values
-    float s_target[3] = {target.x, target.y, target.z};
-    SetShaderValue(shader, target_loc, s_target, SHADER_UNIFORM_VEC3);
+void global::mainLoop() {
+    updateFrame();
+    renderFrame();
+}
 
-    // Send to shader light color values
-    Vector4 s_color = { color.r/255.f, color.g/255.f, color.b/255.f, color.a/255.f };
-    SetShaderValue(shader, color_loc, &s_color, SHADER_UNIFORM_VEC4);
+void global::updateFrame() {
+    frame++;
+    sim_frame = &simulation.get_frame();
+    updateCamera();
+    updateVoxelMesh();
+    updateVisibility();
+    updatePicking();
+    updateEntityBounds();
+    updateLights();
+    updateMemoryStats();
 }
 
-Light::~Light() {
-    if (shadow_map) {
-        // Only unload if it looks valid
-        if (shadow_map->id != 0) {
-            UnloadRenderTexture(*shadow_map);
+void global::renderFrame() {
+    // PASS 1: Render the scheduled lights into their tile of the shadow atlas.
+    // The other tiles (and their lightVP) are left as they were last frame.
+    const auto& shadow_updates = shadow_scheduler.schedule(light_manager.lights, camera.position,
+        scene_revision, moved_entity_bounds);
+    render_backend->begin_target(shadow_atlas.target); {
+        for (const int light_index : shadow_updates) {
+            Light& light = light_manager.lights[light_index];
+            shadow_atlas.begin_slot(light.shadow_slot); {
+                // Same as begin_camera(), but with the (fitted) shadow frustum
+                render_backend->begin_view(light.shadow_view, light.shadow_proj);
+                drawVoxelSceneDepth(Frustum::from_matrix(MatrixMultiply(light.shadow_view, light.shadow_proj)));
+                drawEntitiesDepth();
+                render_backend->end_view();
+            }
+            shadow_atlas.end_slot();
+            // Update lightVP
+            light.light_view_proj = MatrixMultiply(light.shadow_view, light.shadow_proj);
+            shadow_atlas.slot_view_proj[light.shadow_slot] = light.light_view_proj;
         }
-        delete shadow_map;
-        shadow_map = nullptr;
     }
-    else { TraceLog(LOG_DEBUG, "[Light] %i: shadow map already freed!", id); }
+    render_backend->end_target();
+    // PASS 2: Drawing
+    render_backend->begin_frame(RAYWHITE); {
+        render_backend->enable_shader(voxel_shader);
+        render_backend->bind_texture(SHADOW_ATLAS_TEXTURE_UNIT, shadow_atlas.target.depth.id, shadow_atlas_loc);
+        render_backend->set_uniform_matrices(light_vp_loc, shadow_atlas.slot_view_proj.data(), shadow_atlas.get_capacity());
+        light_manager.bind(LIGHT_BUFFER_TEXTURE_UNIT);
+        light_clusters.bind(CLUSTER_TEXTURE_UNIT);
+        render_backend->begin_camera(camera); {
+            drawVoxelScene();
+            drawEntities();
+            if (!render_backend->is_headless()) drawDebugShapes();
+        }
+        render_backend->end_camera();
+        if (!render_backend->is_headless()) drawOverlay();
+    }
+    render_backend->end_frame();
 }
 
-// Move constructor
-Light::Light(Light&& other) noexcept
-    : id(other.id)
-    , type(other.type)
-    , enabled(other.enabled)
-    , position(other.position)
-    , target(other.target)
-    , color(other.color)
-    , attenuation(other.attenuation)
-    , light_camera(other.light_camera)
-    , shadow_map(other.shadow_map) // take ownership
-    , light_view_proj(other.light_view_proj)
-    , enabled_loc(other.enabled_loc)
-    , type_loc(other.type_loc)
-    , position_loc(other.position_loc)
-    , target_loc(other.target_loc)
-    , color_loc(other.color_loc)
-    , attenuation_loc(other.attenuation_loc)
-    , vp_loc(other.vp_loc)
-    , shadow_map_loc(other.shadow_map_loc)
-    , texture_loc(other.texture_loc)
-{
-    other.shadow_map = nullptr;
-}
+int global::runHeadless(const int frames) {
+    render_backend = &null_backend;
+    init();
+
+    double update_time = 0.0, render_time = 0.0;
+    for (int i = 0; i < frames; i++) {
+        // nothing presses any keys, so fly over the map for there to be something to stream and mesh
+        camera.position.x += HEADLESS_CAMERA_SPEED;
+        camera.target.x += HEADLESS_CAMERA_SPEED;
+
+        double t = bench::now();
+        updateFrame();
+        update_time += bench::now() - t;
+        t = bench::now();
+        renderFrame();
+        render_time += bench::now() - t;
+    }
 
-// Move assignment
-Light& Light::operator=(Light&& other) noexcept {
-    if (this != &other) {
-        // Release current ownership first
-        if (shadow_map) {
-            if (shadow_map->id != 0) {
-                UnloadRenderTexture(*shadow_map);
-            }
-            delete shadow_map;
-        }
-        // Take ownership of the render texture pointer
-        shadow_map   = other.shadow_map;
-        other.shadow_map = nullptr;
-
-        // Copies
-        id = other.id;
-        type = other.type;
-        enabled = other.enabled;
-        position = other.position;
-        target = other.target;
-        color = other.color;
-        attenuation = other.attenuation;
-        light_camera = other.light_camera;
-        light_view_proj = other.light_view_proj;
-        enabled_loc = other.enabled_loc;
-        type_loc = other.type_loc;
-        position_loc = other.position_loc;
-        target_loc = other.target_loc;
-        color_loc = other.color_loc;
-        attenuation_loc = other.attenuation_loc;
-        vp_loc = other.vp_loc;
-        shadow_map_loc = other.shadow_map_loc;
-        texture_loc = other.texture_loc;
-    }
-    return *this;
+    const RenderStats& stats = null_backend.get_total_stats();
+    const double n = std::max(stats.frames, 1);
+    TraceLog(LOG_INFO, "[Headless] %i frames: %.3f ms update + %.3f ms render per frame",
+        stats.frames, update_time * 1000.0 / n, render_time * 1000.0 / n);
+    TraceLog(LOG_INFO, "[Headless] per frame: %.1f passes, %.1f draw calls, %.0f triangles, %.0f vertices",
+        stats.passes / n, stats.draw_calls / n, static_cast<double>(stats.triangles) / n, static_cast<double>(stats.vertices) / n);
+    TraceLog(LOG_INFO, "[Headless] %i meshes uploaded, %.1f MB sent to the GPU in total",
+        stats.mesh_uploads, static_cast<double>(stats.uploaded_bytes) / (1024.0 * 1024.0));
+    memory_tracker.dump();
+
+    shutdown();
+    return 0;
 }
 
 Vector3 apply_transform(const Vector3 v, const Transform &t) {
@@ -415,9 +556,16 @@ Vector3 apply_transform(const Vector3 v, const Transform &t) {
 }
 
 bool global::isInRenderDistance(const Vector3 v) {
-    // TODO (optimisation) this should be rewritten so that it doesn't use a sqrt operation
-    return Vector3Distance(camera.position, v) <= render_distance
-    || !limit_render_distance;
+    return !limit_render_distance
+        || Vector3DistanceSqr(camera.position, v) <= render_distance * render_distance;
+}
+
+Matrix global::getEntityMatrix(const SimSnapshot& snapshot, const size_t i, const ModelInfo& model_info) {
+    // Map (x,y,z) -> Render (X=x, Y=z, Z=y), heading 0 faces +x
+    const Vector3 p = snapshot.entity_positions[i];
+    const Matrix rotation = MatrixRotateY(-snapshot.entity_headings[i]);
+    const Matrix translation = MatrixTranslate(p.x * voxel_scale, p.z * voxel_scale, p.y * voxel_scale);
+    return MatrixMultiply(MatrixMultiply(model_info.world_matrix, rotation), translation);
 }
 
 std::string global::loadFile(const std::string& path) {
@@ -430,79 +578,206 @@ std::string global::loadFile(const std::string& path) {
     return buffer.str();
 }
 
-raylib::Shader global::loadAndPatchShader(const std::string& shader_path, int light_count) {
+raylib::Shader global::loadShader(const std::string& shader_path) {
     std::string vertex = loadFile(shader_path + ".vs");
     std::string fragment = loadFile(shader_path + ".fs");
 
-    // Regex for finding the declaration in the file
-    static const std::regex shadow_decl{
-        R"(\buniform\s+sampler2D\s+shadowMap\b\s*;)",
-        std::regex::ECMAScript
-    };
-    static const std::regex vp_decl{
-        R"(\buniform\s+mat4\s+lightVP\b\s*;)",
-        std::regex::ECMAScript
-    };
-    static const std::regex shadow_get_decl{R"(GetShadowMapFunction)", std::regex::ECMAScript};
-    static const std::regex vp_get_decl{R"(GetLightVPFunction)", std::regex::ECMAScript};
-    static const std::regex max_lights_define{R"(#define MAX_LIGHTS x)", std::regex::ECMAScript};
-
-    // Build replacement block
-    std::ostringstream shadow_oss, vp_oss, shadow_get_oss, vp_get_oss;
-    for (std::size_t i = 0; i < light_count; ++i) {
-        shadow_oss << "uniform sampler2D shadowMap" << i << ";\n";
-        vp_oss << "uniform mat4 lightVP" << i << ";\n";
-
-        if (i != light_count - 1) {
-            shadow_get_oss << "    if (i == " << i << ") return texture(shadowMap" << i << ", uv).r;\n";
-            vp_get_oss     << "    if (i == " << i << ") return lightVP"   << i << ";\n";
-        } else {
-            // last iterator
-            shadow_get_oss << "    return texture(shadowMap" << i << ", uv).r;";
-            vp_get_oss     << "    return lightVP"   << i << ";";
-        }
-    }
-    // Patching
-    auto fragment_patched = std::regex_replace(fragment, shadow_decl, shadow_oss.str());
-    fragment_patched = std::regex_replace(fragment_patched, vp_decl, vp_oss.str());
-    fragment_patched = std::regex_replace(fragment_patched, shadow_get_decl, shadow_get_oss.str());
-    fragment_patched = std::regex_replace(fragment_patched, vp_get_decl, vp_get_oss.str());
-    std::string new_lights_define = "#define MAX_LIGHTS " + std::to_string(light_count);
-    fragment_patched = std::regex_replace(fragment_patched, max_lights_define, new_lights_define);
+    // The array sizes are shared with the C++ side, so they are
+    // defined right after the #version line instead of in the file
+    std::ostringstream defines;
+    defines << "#define MAX_LIGHTS " << MAX_LIGHTS << "\n";
+    defines << "#define MAX_SHADOW_SLOTS " << MAX_SHADOW_SLOTS << "\n";
+    defines << "#define CLUSTER_INDEX_WIDTH " << CLUSTER_INDEX_WIDTH << "\n";
+
+    auto version_end = fragment.find('\n', fragment.find("#version"));
+    if (version_end == std::string::npos) version_end = 0;
+    else version_end += 1;
+    fragment.insert(version_end, defines.str());
 
-    return LoadShaderFromMemory(vertex.c_str(), fragment_patched.c_str());
+    return render_backend->load_shader(vertex.c_str(), fragment.c_str());
 }
 
 void global::drawVoxelScene() {
-    for (VoxelGrid* grid : voxel_grids) {
-        for (ModelInfo* model_info : grid->get_models()) {
-            drawVoxelModel(*model_info);
-        }
+    // Already frustum culled in updateVisibility()
+    for (ModelInfo* model_info : visible_models) {
+        drawVoxelModel(*model_info);
     }
 }
 
 void global::drawVoxelModel(const ModelInfo& model_info) {
-    // Offset
-    auto offset = Vector3Scale(model_info.transform.translation, voxel_scale);
+    const Model& model = model_info.model;
 
-    // Rotation
-    auto axis = Vector3{};
-    auto angle = 0.0f;
-    QuaternionToAxisAngle(model_info.transform.rotation, &axis, &angle);
+    // Same as DrawModelEx(), with the matrix cached by the model's grid
+    for (int i = 0; i < model.meshCount; i++) {
+        render_backend->draw_mesh(model.meshes[i], model.materials[model.meshMaterial[i]], model_info.world_matrix);
+    }
+}
 
-    // Scale
-    auto scale = Vector3Scale(model_info.transform.scale, voxel_scale);
+void global::drawVoxelSceneDepth(const Frustum& frustum) {
+    spatial_index.query_frustum(frustum, spatial_results);
+    for (const SpatialItem& item : spatial_results) {
+        const Matrix& m = item.model->world_matrix;
+        if (!isInRenderDistance(Vector3{m.m12, m.m13, m.m14})) continue;
+        drawVoxelModelDepth(*item.model);
+    }
+}
 
-    // Drawing the model
-    DrawModelEx(model_info.model, offset,
-        axis, angle, scale, WHITE);
+void global::drawVoxelModelDepth(const ModelInfo& model_info) {
+    const Model& model = model_info.model;
 
-    // Drawing wires
-    // DrawModelWiresEx(model_info->model, offset,
-    //     axis, angle, scale, DARKGRAY);
+    // The material's own shader (voxel_shader) would run the full lighting
+    // for every shadow map fragment, only for the colour to be thrown away.
+    for (int i = 0; i < model.meshCount; i++) {
+        render_backend->draw_mesh(model.meshes[i], depth_material, model_info.world_matrix);
+    }
 }
 
-int main() {
+void global::drawEntities() {
+    for (size_t i = 0; i < sim_frame->entity_ids.size(); i++) {
+        const int model_id = sim_frame->entity_models[i];
+        if (model_id < 0) continue;
+        for (ModelInfo* model_info : entity_models[model_id]->get_models()) {
+            if (model_info == nullptr) continue;
+            const Model& model = model_info->model;
+            const Matrix transform = getEntityMatrix(*sim_frame, i, *model_info);
+            for (int m = 0; m < model.meshCount; m++) {
+                render_backend->draw_mesh(model.meshes[m], model.materials[model.meshMaterial[m]], transform);
+            }
+        }
+    }
+}
+
+void global::drawEntitiesDepth() {
+    for (size_t i = 0; i < sim_frame->entity_ids.size(); i++) {
+        const int model_id = sim_frame->entity_models[i];
+        if (model_id < 0) continue;
+        for (ModelInfo* model_info : entity_models[model_id]->get_models()) {
+            if (model_info == nullptr) continue;
+            const Matrix transform = getEntityMatrix(*sim_frame, i, *model_info);
+            for (int m = 0; m < model_info->model.meshCount; m++) {
+                render_backend->draw_mesh(model_info->model.meshes[m], depth_material, transform);
+            }
+        }
+    }
+}
+
+void global::drawDebugShapes() {
+    // Shader Mode is only necessary for immediate draw calls
+    BeginShaderMode(voxel_shader); {
+        // Test Cube
+        DrawCube(Vector3{0.0, 0.0, 0.0}, 1.0, 1.0, 1.0, ORANGE);
+    }
+    EndShaderMode();
+
+    // Draw spheres to show where the directional lights are
+    for (Light& light : light_manager.lights) {
+        if (light.type != DIRECTIONAL_LIGHT) continue;
+        if (light.enabled) DrawSphereEx(light.position, 0.2f, 8, 8, light.color);
+        else DrawSphereWires(light.position, 0.2f, 8, 8, ColorAlpha(light.color, 0.3f));
+    }
+
+    // Path between the clicked tiles and the roads, just above the ground
+    auto on_ground = [](const Int2 tile) {
+        const int z = game_map->get_surface_height(tile);
+        return get_voxel_world_position(*game_map, Int3{tile.x, tile.y, z});
+    };
+    for (size_t i = 1; i < path_preview.size(); i++) {
+        DrawLine3D(on_ground(path_preview[i - 1]), on_ground(path_preview[i]), MAGENTA);
+    }
+    for (const auto& [chunk_pos, chunk] : network->chunks) {
+        for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+            const Int2 tile = {chunk_pos.x * CHUNK_SIZE + i % CHUNK_SIZE, chunk_pos.y * CHUNK_SIZE + i / CHUNK_SIZE};
+            // every road once, from its west or south end
+            if (chunk.links[i] & LINK_EAST) DrawLine3D(on_ground(tile), on_ground({tile.x + 1, tile.y}), DARKGRAY);
+            if (chunk.links[i] & LINK_NORTH) DrawLine3D(on_ground(tile), on_ground({tile.x, tile.y + 1}), DARKGRAY);
+        }
+    }
+
+    // Outline the voxel under the mouse
+    if (hovered_voxel.has_value()) {
+        const VoxelGrid& grid = *hovered_voxel->grid;
+        // lengths of the grid's axes in render space
+        const Matrix& m = grid.get_world_matrix();
+        const Vector3 size = Vector3Scale(Vector3{
+            Vector3Length(Vector3{m.m0, m.m1, m.m2}),
+            Vector3Length(Vector3{m.m4, m.m5, m.m6}),
+            Vector3Length(Vector3{m.m8, m.m9, m.m10})}, 1.02f);
+        DrawCubeWiresV(get_voxel_world_position(grid, hovered_voxel->voxel), size, RED);
+    }
+}
+
+void global::drawOverlay() {
+    if (show_occlusion_stats && occlusion_culling) {
+        OcclusionStats stats = occlusion_culler.get_stats();
+        DrawText(TextFormat("occlusion: %d occluders, %d/%d chunks rejected",
+            stats.occluders, stats.rejected, stats.tested), 10, 10, 20, DARKGRAY);
+    }
+    if (show_sim_stats) {
+        SimStats stats = simulation.get_stats();
+        DrawText(TextFormat("sim: tick %llu, %i ticks/s, %.2f ms/tick, %llu dropped",
+            static_cast<unsigned long long>(sim_frame->tick), stats.ticks_per_second, stats.tick_ms,
+            static_cast<unsigned long long>(stats.dropped_ticks)), 10, 60, 20, DARKGRAY);
+        const EconomyStats& economy = sim_frame->economy;
+        DrawText(TextFormat("economy: year %u month %u, $%.0f ($%.0f last month), %lld people",
+            economy.day / (ECONOMY_DAYS_PER_MONTH * ECONOMY_MONTHS_PER_YEAR) + 1,
+            economy.day / ECONOMY_DAYS_PER_MONTH % ECONOMY_MONTHS_PER_YEAR + 1,
+            economy.money, economy.income_last_month, economy.population), 10, 110, 20, DARKGRAY);
+    }
+    if (show_memory_stats) {
+        ModelMemoryStats stats = game_map->get_model_stats();
+        size_t other_bytes = 0;
+        for (VoxelGrid* grid : voxel_grids) {
+            if (grid != game_map) other_bytes += grid->model_bytes;
+        }
+        DrawText(TextFormat("chunk meshes: %.1f / %.0f MB, %d loaded, %d evicted (%d evictions, %d rebuilt), other grids %.1f KB",
+            static_cast<double>(stats.bytes) / (1024.0 * 1024.0), static_cast<double>(stats.budget) / (1024.0 * 1024.0),
+            stats.models, stats.evicted, stats.evictions, stats.rebuilt, static_cast<double>(other_bytes) / 1024.0),
+            10, 160, 20, DARKGRAY);
+        if (stats.remesh_backlog > 0) {
+            DrawText(TextFormat("%d chunks waiting to be remeshed", stats.remesh_backlog), 10, 185, 20, DARKGRAY);
+        }
+        const MemoryTagStats voxels = memory_tracker.get_stats(MemoryTag::Chunks);
+        const MemoryTagStats scratch = memory_tracker.get_stats(MemoryTag::MesherScratch);
+        DrawText(TextFormat("memory: %.1f MB RAM (%.1f MB voxels, %.1f MB peak mesher scratch), %.1f MB GPU, M to log it all",
+            static_cast<double>(memory_tracker.get_total_bytes(false)) / (1024.0 * 1024.0),
+            static_cast<double>(voxels.bytes) / (1024.0 * 1024.0), static_cast<double>(scratch.peak) / (1024.0 * 1024.0),
+            static_cast<double>(memory_tracker.get_total_bytes(true)) / (1024.0 * 1024.0)), 10, 210, 20, DARKGRAY);
+    }
+    if (game_map->is_streaming()) {
+        StreamStats stats = game_map->get_stream_stats();
+        DrawText(TextFormat("streaming: %d chunks loaded, %d pending, %d saved, %d generated, %d evicted",
+            stats.loaded, stats.pending, stats.saved, stats.generated, stats.evicted), 10, 135, 20, DARKGRAY);
+    }
+    if (show_network_stats) {
+        NetworkStats stats = network->get_stats();
+        DrawText(TextFormat("roads: %d tiles, %d networks, routes %d cached/%d searched",
+            stats.road_tiles, stats.components, stats.route_hits, stats.route_misses), 10, 85, 20, DARKGRAY);
+    }
+    if (hovered_voxel.has_value()) {
+        const Int3 v = hovered_voxel->voxel;
+        const Int3 n = hovered_voxel->normal;
+        DrawText(TextFormat("voxel (%d, %d, %d), face (%d, %d, %d), %.1f away",
+            v.x, v.y, v.z, n.x, n.y, n.z, hovered_voxel->distance), 10, 35, 20, DARKGRAY);
+    }
+}
+
+int main(int argc, char** argv) {
+    // Headless benchmarks, see bench/Bench.hpp
+    if (argc >= 3 && std::string(argv[1]) == "--bench") {
+        return bench::run(argv[2], bench::BenchArgs(argv + 3, argv + argc));
+    }
+
+    // --headless [frames]: the whole game without a window or GPU, see global::runHeadless()
+    int headless_frames = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--stream") global::stream_world = true;
+        if (std::string(argv[i]) == "--headless") {
+            headless_frames = HEADLESS_FRAMES;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) headless_frames = std::atoi(argv[++i]);
+        }
+    }
+    if (headless_frames > 0) return global::runHeadless(headless_frames);
+
     global::init();
 
 #if defined(PLATFORM_WEB)
@@ -5,100 +5,158 @@
 #ifndef BUSINESS_GAME_MAIN_HPP
 #define BUSINESS_GAME_MAIN_HPP
 #include <Camera3D.hpp>
-#include <RenderTexture.hpp>
 #include <Shader.hpp>
 #include <vector>
 #include "voxel/VoxelMap.hpp"
-
-#define SHADOWMAP_RESOLUTION 1024
-
-// Light data
-// taken from https://github.com/raysan5/raylib/blob/fbdf5e4fd2cb2ddd37d81e1c499797f3a2801ab5/examples/models/rlights.h#L46
-enum LightType {
-    DIRECTIONAL_LIGHT = 0,
-    POINT_LIGHT = 1,
-};
-
-struct Light {
-    unsigned int id{};
-    int type{};
-    bool enabled{true};
-    Vector3 position{};
-    Vector3 target{};
-    Color color{WHITE};
-    float attenuation{1.0f}; // not used
-
-    Camera3D light_camera;
-    raylib::RenderTexture2D* shadow_map = nullptr;
-    Matrix light_view_proj{};
-
-    // Shader locations
-    int enabled_loc{-1};
-    int type_loc{-1};
-    int position_loc{-1};
-    int target_loc{-1};
-    int color_loc{-1};
-    int attenuation_loc{-1}; // not used
-    int vp_loc{-1};
-    int shadow_map_loc{-1};
-    int texture_loc{-1};
-
-    void update(Shader shader);
-
-    // Factory: creates, initializes, registers, and returns the index of the Light.
-    // Side Effects: edits global::lights and global::next_light_id
-    static size_t create(LightType type, Vector3 pos, Vector3 target, Color color, const Shader& shader);
-
-    Light() = default;
-    ~Light();
-
-    Light(Light&& other) noexcept; // implement this
-    Light& operator=(Light&& other) noexcept; // and implement this
-
-    Light(const Light&) = delete;
-    Light& operator=(const Light&) = delete;
-};
-
+#include "voxel/VoxelRaycast.hpp"
+#include "path/TerrainPathfinder.hpp"
+#include "network/TransportNetwork.hpp"
+#include "sim/Simulation.hpp"
+#include "render/ShadowAtlas.hpp"
+#include "render/LightManager.hpp"
+#include "render/ShadowScheduler.hpp"
+#include "render/OcclusionCuller.hpp"
+#include "render/ClusteredLighting.hpp"
+#include "render/SpatialIndex.hpp"
+#include "render/RaylibBackend.hpp"
+#include "render/NullBackend.hpp"
+#include "game/MemoryTracker.hpp"
+
+#define SHADOWMAP_RESOLUTION 1024 // of a single light (one atlas tile)
+#define SHADOW_ATLAS_TILES 4      // tiles per side, 4x4 = 16 shadow casting lights
+#define SHADOW_ATLAS_TEXTURE_UNIT 10 // the 10 is kinda arbitrary
+#define CLUSTER_TEXTURE_UNIT 11      // uses 11 and 12
+#define LIGHT_BUFFER_TEXTURE_UNIT 13
+#define HEADLESS_FRAMES 600          // run by --headless if it isn't given a number
+#define HEADLESS_CAMERA_SPEED 0.05f  // render units the camera flies per headless frame
 
 namespace global {
+    // Every GPU call goes through render_backend, --headless swaps it for null_backend
+    inline RaylibBackend raylib_backend;
+    inline NullBackend null_backend;
+    inline RenderBackend* render_backend = &raylib_backend;
+
     inline float voxel_scale = 0.2f;
-    //TODO (Broken!) render circle is somehow not centered at the camera
-    // has something to do with voxel_scale; it works perfectly if voxel_scale=0
     inline float render_distance = 128.0f;
     inline bool limit_render_distance = false;
 
     inline raylib::Camera camera;
     inline raylib::Shader voxel_shader;
+    // Minimal shader used for the shadow passes, only writes depth
+    inline raylib::Shader depth_shader;
+    inline Material depth_material;
 
     inline float ambient[4] = {0.06f, 0.06f, 0.06f, 1.0f};
-    inline unsigned int next_light_id = 0;
-    inline std::vector<Light> lights;
-    inline size_t sun_light_id;
-    inline size_t camera_light_id;
+    inline LightManager light_manager;
+    inline ShadowAtlas shadow_atlas;
+    inline int shadow_atlas_loc = -1;
+    inline int light_vp_loc = -1;
+    inline int sun_light_id;
+    inline int camera_light_id;
     inline bool move_camera_light = true;
+    // Fit the directional lights' shadow frustums to the visible chunks every frame
+    inline bool fit_shadows = true;
+    // Picks which shadow maps are rendered each frame
+    inline ShadowScheduler shadow_scheduler;
+    // Sum of every grid's revision and transform revision, changes whenever a chunk is remeshed or a grid moves
+    inline unsigned int scene_revision = 0;
+
+    // Street lamps etc. are point lights, shaded with clustered forward lighting
+    inline ClusteredLighting light_clusters;
+    inline bool point_lights_enabled = true;
 
     inline std::vector<VoxelGrid*> voxel_grids;
+    // Every model of voxel_grids by its world bounds, used for all the culling and picking
+    inline SpatialIndex spatial_index;
+    inline std::vector<SpatialItem> spatial_results; // reused by the queries
     inline VoxelMap* game_map;
+    // Set by --stream: game_map is generated around the camera instead of all at once
+    inline bool stream_world = false;
+
+    inline uint64_t frame = 0; // counts mainLoop() calls
+    inline bool show_memory_stats = true;
+    // Bytes in use by chunks, meshes, lights and shadow maps, M logs all of it
+    inline MemoryTracker memory_tracker;
+
+    // Rebuilt every frame by updateVisibility()
+    inline std::vector<ModelInfo*> visible_models;  // inside the camera frustum
+    inline std::vector<BoundingBox> visible_bounds; // world bounds of visible_models
+    inline std::vector<BoundingBox> caster_bounds;  // world bounds of the models that can shadow visible_models, per light
+
+    // Removes the chunks hidden behind terrain from visible_models
+    inline OcclusionCuller occlusion_culler;
+    inline bool occlusion_culling = true;
+    inline bool show_occlusion_stats = true;
+
+    // Voxel under the mouse, updated every frame by updatePicking()
+    inline std::optional<VoxelHit> hovered_voxel;
+    inline float pick_distance = 100.0f;
+    inline std::vector<VoxelGrid*> picked_grids; // grids along the mouse ray
+
+    // Left click picks where a path starts, right click where it goes
+    inline TerrainPathfinder* pathfinder;
+    inline std::optional<Int2> path_start;
+    inline std::vector<Int2> path_preview;
+    // Roads: B builds one along path_preview, V demolishes it
+    inline TransportNetwork* network;
+    inline bool show_network_stats = true;
+
+    // Runs on its own thread, sim_frame is its state interpolated to this frame
+    inline Simulation simulation;
+    inline const SimSnapshot* sim_frame = nullptr;
+    // Voxel models of the entities, indexed by EntityStore::models
+    inline std::vector<VoxelGrid*> entity_models;
+    inline Vector3 sun_offset; // sun position - sun target, at sun_angle 0
+    inline bool show_sim_stats = true;
+    // World bounds of every entity in sim_frame, this frame's and last frame's
+    inline std::vector<std::pair<EntityId, BoundingBox>> entity_bounds, last_entity_bounds;
+    // Where the entities that moved since last frame were and are, their shadows need rendering again
+    inline std::vector<BoundingBox> moved_entity_bounds;
 
     // Main Functions, only called inside main
     static void init();
     static void mainLoop();
     static void shutdown();
+    // Runs frames of mainLoop() on null_backend, with the camera flying along x, and logs how long they took
+    static int runHeadless(int frames);
+
+    // The two halves of mainLoop()
+    static void updateFrame();
+    static void renderFrame();
 
     // Update Functions, called every tick
     static void updateCamera();
     static void updateLights();
     static void updateVoxelMesh();
+    static void updateVisibility();
+    static void updatePicking();
+    // Fills entity_bounds and moved_entity_bounds
+    static void updateEntityBounds();
+    // Measures the lights and the shadow atlas for memory_tracker, M logs everything it has
+    static void updateMemoryStats();
 
     // Drawing Functions
-    // Should always be within a BeginMode3D()/EndMode3D() block.
+    // Should always be within a render_backend->begin_camera()/end_camera() block.
+    // Only draws visible_models
     void drawVoxelScene();
     void drawVoxelModel(const ModelInfo& model_info);
+    // Same as above, but every mesh in the frustum is drawn with depth_material (for shadow maps)
+    void drawVoxelSceneDepth(const Frustum& frustum);
+    void drawVoxelModelDepth(const ModelInfo& model_info);
+    // Every entity of sim_frame, with its model from entity_models
+    void drawEntities();
+    void drawEntitiesDepth();
+    // Lights, paths, roads and the hovered voxel, in raylib's immediate mode (not on headless backends)
+    void drawDebugShapes();
+    // Stats text, same as above
+    void drawOverlay();
 
     // Helper Functions
     bool isInRenderDistance(Vector3 v);
+    // Places a model of entity_models at entity i of the snapshot
+    Matrix getEntityMatrix(const SimSnapshot& snapshot, size_t i, const ModelInfo& model_info);
     std::string loadFile(const std::string& path);
-    raylib::Shader loadAndPatchShader(const std::string& shader_path, int light_count);
+    raylib::Shader loadShader(const std::string& shader_path);
 }
 
 Vector3 apply_transform(Vector3 v, const Transform &t);
@@ -0,0 +1,319 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "network/TransportNetwork.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+// The link from one tile to its neighbour, 0 if they aren't neighbours
+static uint8_t getLink(const Int2 from, const Int2 to) {
+    const int dx = to.x - from.x, dy = to.y - from.y;
+    if (dx == 1 && dy == 0) return LINK_EAST;
+    if (dx == 0 && dy == 1) return LINK_NORTH;
+    if (dx == -1 && dy == 0) return LINK_WEST;
+    if (dx == 0 && dy == -1) return LINK_SOUTH;
+    return 0;
+}
+
+static uint8_t getOppositeLink(const uint8_t link) {
+    return static_cast<uint8_t>(((link << 2) | (link >> 2)) & 0xF);
+}
+
+// Floor division, so tiles left of or below the map don't end up in chunk 0
+static Int2 getChunkPos(const Int2 tile) {
+    return Int2{
+        tile.x >= 0 ? tile.x / CHUNK_SIZE : (tile.x + 1) / CHUNK_SIZE - 1,
+        tile.y >= 0 ? tile.y / CHUNK_SIZE : (tile.y + 1) / CHUNK_SIZE - 1,
+    };
+}
+
+static int localIndex(const Int2 tile) {
+    const Int2 chunk_pos = getChunkPos(tile);
+    return (tile.x - chunk_pos.x * CHUNK_SIZE) + (tile.y - chunk_pos.y * CHUNK_SIZE) * CHUNK_SIZE;
+}
+
+TransportNetwork::TransportNetwork(const VoxelMap* map) : map(map) {
+    const Int2 chunk_count = map->get_chunk_count();
+    size = Int2{chunk_count.x * CHUNK_SIZE, chunk_count.y * CHUNK_SIZE};
+}
+
+NetworkChunk* TransportNetwork::get_network_chunk(const Int2 tile, const bool create) {
+    const Int2 chunk_pos = getChunkPos(tile);
+    if (create) return &chunks[chunk_pos];
+    const auto chunk = chunks.find(chunk_pos);
+    return chunk == chunks.end() ? nullptr : &chunk->second;
+}
+
+int* TransportNetwork::get_node(const Int2 tile) {
+    NetworkChunk* chunk = get_network_chunk(tile, false);
+    return chunk == nullptr ? nullptr : &chunk->nodes[localIndex(tile)];
+}
+
+uint8_t TransportNetwork::get_links(const Int2 tile) const {
+    const auto chunk = chunks.find(getChunkPos(tile));
+    if (chunk == chunks.end()) return 0;
+    return chunk->second.links[localIndex(tile)];
+}
+
+void TransportNetwork::get_neighbours(const Int2 tile, std::vector<Int2>& out) const {
+    out.clear();
+    const uint8_t links = get_links(tile);
+    if (links & LINK_EAST) out.emplace_back(Int2{tile.x + 1, tile.y});
+    if (links & LINK_NORTH) out.emplace_back(Int2{tile.x, tile.y + 1});
+    if (links & LINK_WEST) out.emplace_back(Int2{tile.x - 1, tile.y});
+    if (links & LINK_SOUTH) out.emplace_back(Int2{tile.x, tile.y - 1});
+}
+
+int TransportNetwork::find(int node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]]; // path halving
+        node = parent[node];
+    }
+    return node;
+}
+
+int TransportNetwork::new_node() {
+    const int node = static_cast<int>(parent.size());
+    parent.emplace_back(node);
+    component_size.emplace_back(1);
+    component_revision.emplace_back(++edits);
+    stats.components++;
+    return node;
+}
+
+void TransportNetwork::unite(const int a, const int b) {
+    int root_a = find(a), root_b = find(b);
+    if (root_a == root_b) return;
+    if (component_size[root_a] < component_size[root_b]) std::swap(root_a, root_b);
+    parent[root_b] = root_a;
+    component_size[root_a] += component_size[root_b];
+    stats.components--;
+}
+
+bool TransportNetwork::add_link(const Int2 a, const Int2 b) {
+    const uint8_t link = getLink(a, b);
+    if (link == 0) return false;
+    for (const Int2 tile : {a, b}) {
+        if (tile.x < 0 || tile.y < 0 || tile.x >= size.x || tile.y >= size.y) return false;
+    }
+    const int height_a = map->get_surface_height(a), height_b = map->get_surface_height(b);
+    if (height_a == 0 || height_b == 0 || std::abs(height_a - height_b) > NETWORK_MAX_CLIMB) return false;
+
+    NetworkChunk* chunk_a = get_network_chunk(a, true);
+    NetworkChunk* chunk_b = get_network_chunk(b, true);
+    const int index_a = localIndex(a), index_b = localIndex(b);
+    if (chunk_a->links[index_a] & link) return false; // already there, nothing built
+
+    // Tiles that weren't on the network start as a network of their own
+    for (auto [chunk, index] : {std::pair{chunk_a, index_a}, std::pair{chunk_b, index_b}}) {
+        if (chunk->links[index] != 0) continue;
+        chunk->nodes[index] = new_node();
+        chunk->road_tiles++;
+        stats.road_tiles++;
+    }
+    chunk_a->links[index_a] |= link;
+    chunk_b->links[index_b] |= getOppositeLink(link);
+
+    unite(chunk_a->nodes[index_a], chunk_b->nodes[index_b]);
+    component_revision[find(chunk_a->nodes[index_a])] = ++edits;
+    return true;
+}
+
+bool TransportNetwork::remove_link(const Int2 a, const Int2 b) {
+    const uint8_t link = getLink(a, b);
+    if (link == 0 || (get_links(a) & link) == 0) return false;
+
+    NetworkChunk* chunk_a = get_network_chunk(a, false);
+    NetworkChunk* chunk_b = get_network_chunk(b, false);
+    const int index_a = localIndex(a), index_b = localIndex(b);
+    const int root = find(chunk_a->nodes[index_a]);
+    chunk_a->links[index_a] &= ~link;
+    chunk_b->links[index_b] &= ~getOppositeLink(link);
+    component_revision[root] = ++edits;
+
+    // Tiles without any road left are off the network
+    for (auto [chunk, index] : {std::pair{chunk_a, index_a}, std::pair{chunk_b, index_b}}) {
+        if (chunk->links[index] != 0) continue;
+        chunk->nodes[index] = -1;
+        chunk->road_tiles--;
+        stats.road_tiles--;
+        if (--component_size[root] == 0) stats.components--;
+    }
+    const bool both_left = chunk_a->links[index_a] != 0 && chunk_b->links[index_b] != 0;
+    for (const Int2 tile : {a, b}) {
+        const auto chunk = chunks.find(getChunkPos(tile));
+        if (chunk != chunks.end() && chunk->second.road_tiles == 0) chunks.erase(chunk);
+    }
+
+    if (both_left) split_if_disconnected(a, b);
+    // Splits leave nodes behind that no tile points at anymore
+    if (parent.size() > 2 * static_cast<size_t>(stats.road_tiles) + 1024) rebuild_components();
+    return true;
+}
+
+void TransportNetwork::split_if_disconnected(const Int2 a, const Int2 b) {
+    // Breadth first from both ends, one tile each in turn
+    auto key = [&](const Int2 tile) { return tile.x + tile.y * size.x; };
+    std::vector<Int2> sides[2] = {{a}, {b}};
+    size_t heads[2] = {0, 0};
+    std::unordered_map<int, int> seen = {{key(a), 0}, {key(b), 1}};
+    std::vector<Int2> neighbours;
+
+    while (true) {
+        for (int s = 0; s < 2; s++) {
+            if (heads[s] == sides[s].size()) {
+                // This side ran out without reaching the other one: it is a network of its own now
+                const int old_root = find(*get_node(sides[s][0]));
+                const int node = new_node();
+                const int count = static_cast<int>(sides[s].size());
+                component_size[node] = count;
+                component_size[old_root] -= count;
+                component_revision[old_root] = ++edits;
+                for (const Int2 tile : sides[s]) *get_node(tile) = node;
+                stats.splits++;
+                return;
+            }
+            const Int2 tile = sides[s][heads[s]++];
+            get_neighbours(tile, neighbours);
+            for (const Int2 next : neighbours) {
+                const auto [it, inserted] = seen.emplace(key(next), s);
+                if (inserted) sides[s].emplace_back(next);
+                else if (it->second != s) return; // met the other side, still connected
+            }
+        }
+    }
+}
+
+void TransportNetwork::rebuild_components() {
+    parent.clear();
+    component_size.clear();
+    component_revision.clear();
+    route_cache.clear();
+    stats.components = 0;
+    for (auto& [chunk_pos, chunk] : chunks) chunk.nodes.fill(-1);
+
+    std::vector<Int2> open, neighbours;
+    for (auto& [chunk_pos, chunk] : chunks) {
+        for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) {
+            if (chunk.links[i] == 0 || chunk.nodes[i] >= 0) continue;
+            const int node = new_node();
+            chunk.nodes[i] = node;
+            int count = 1;
+            open = {Int2{chunk_pos.x * CHUNK_SIZE + i % CHUNK_SIZE, chunk_pos.y * CHUNK_SIZE + i / CHUNK_SIZE}};
+            while (!open.empty()) {
+                const Int2 tile = open.back();
+                open.pop_back();
+                get_neighbours(tile, neighbours);
+                for (const Int2 next : neighbours) {
+                    int* next_node = get_node(next);
+                    if (*next_node >= 0) continue;
+                    *next_node = node;
+                    count++;
+                    open.emplace_back(next);
+                }
+            }
+            component_size[node] = count;
+        }
+    }
+}
+
+int TransportNetwork::build_road(const std::vector<Int2>& tiles) {
+    int built = 0;
+    for (size_t i = 1; i < tiles.size(); i++) {
+        if (add_link(tiles[i - 1], tiles[i])) built++;
+    }
+    return built;
+}
+
+int TransportNetwork::remove_road(const std::vector<Int2>& tiles) {
+    int removed = 0;
+    for (size_t i = 1; i < tiles.size(); i++) {
+        if (remove_link(tiles[i - 1], tiles[i])) removed++;
+    }
+    return removed;
+}
+
+void TransportNetwork::clear() {
+    chunks.clear();
+    parent.clear();
+    component_size.clear();
+    component_revision.clear();
+    route_cache.clear();
+    stats = NetworkStats{};
+}
+
+bool TransportNetwork::is_connected(const Int2 a, const Int2 b) {
+    const int* node_a = get_node(a);
+    const int* node_b = get_node(b);
+    if (node_a == nullptr || node_b == nullptr || *node_a < 0 || *node_b < 0) return false;
+    return find(*node_a) == find(*node_b);
+}
+
+const std::vector<Int2>& TransportNetwork::find_route(const Int2 a, const Int2 b) {
+    static const std::vector<Int2> no_route;
+    if (!is_connected(a, b)) return no_route;
+
+    const int root = find(*get_node(a));
+    const uint64_t key = static_cast<uint64_t>(a.x + a.y * size.x) << 32 | static_cast<uint32_t>(b.x + b.y * size.x);
+    const auto cached = route_cache.find(key);
+    if (cached != route_cache.end() && cached->second.revision == component_revision[root]) {
+        stats.route_hits++;
+        return cached->second.tiles;
+    }
+
+    stats.route_misses++;
+    if (cached == route_cache.end() && route_cache.size() >= NETWORK_ROUTE_CACHE) route_cache.clear();
+    CachedRoute& route = route_cache[key];
+    route.revision = component_revision[root];
+    route.tiles = search_route(a, b);
+    return route.tiles;
+}
+
+std::vector<Int2> TransportNetwork::search_route(const Int2 a, const Int2 b) const {
+    // A* along the roads, every link costs the same
+    auto key = [&](const Int2 tile) { return tile.x + tile.y * size.x; };
+    auto estimate = [&](const Int2 tile) { return std::abs(tile.x - b.x) + std::abs(tile.y - b.y); };
+    struct Open {
+        int f;
+        int g;
+        Int2 tile;
+        bool operator>(const Open& other) const { return f > other.f || (f == other.f && g < other.g); }
+    };
+    std::priority_queue<Open, std::vector<Open>, std::greater<>> open;
+    std::unordered_map<int, std::pair<int, Int2>> visited; // tile -> (g, came from)
+    std::vector<Int2> neighbours;
+
+    open.push({estimate(a), 0, a});
+    visited[key(a)] = {0, a};
+    while (!open.empty()) {
+        const Open current = open.top();
+        open.pop();
+        if (current.tile == b) break;
+        if (current.g > visited[key(current.tile)].first) continue; // stale
+
+        get_neighbours(current.tile, neighbours);
+        for (const Int2 next : neighbours) {
+            const int g = current.g + 1;
+            const auto [it, inserted] = visited.try_emplace(key(next), g, current.tile);
+            if (!inserted) {
+                if (it->second.first <= g) continue;
+                it->second = {g, current.tile};
+            }
+            open.push({g + estimate(next), g, next});
+        }
+    }
+
+    std::vector<Int2> tiles;
+    if (!visited.contains(key(b))) return tiles;
+    for (Int2 tile = b; !(tile == a); tile = visited[key(tile)].second) tiles.emplace_back(tile);
+    tiles.emplace_back(a);
+    std::reverse(tiles.begin(), tiles.end());
+    return tiles;
+}
+
+NetworkStats TransportNetwork::get_stats() const {
+    return stats;
+}
@@ -0,0 +1,109 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_TRANSPORTNETWORK_HPP
+#define BUSINESS_GAME_TRANSPORTNETWORK_HPP
+#include <array>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "voxel/VoxelMap.hpp"
+
+#define NETWORK_MAX_CLIMB 1       // highest step (in voxels) a road can go up or down between two tiles
+#define NETWORK_ROUTE_CACHE 4096  // cached routes, the cache is emptied when it gets bigger than this
+
+// Bits of NetworkChunk::links, which neighbours a tile has a road to
+enum NetworkLink : uint8_t {
+    LINK_EAST = 1,  // x + 1
+    LINK_NORTH = 2, // y + 1
+    LINK_WEST = 4,  // x - 1
+    LINK_SOUTH = 8, // y - 1
+};
+
+struct NetworkChunk {
+    std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE> links{}; // per tile, x + y * CHUNK_SIZE
+    std::array<int, CHUNK_SIZE * CHUNK_SIZE> nodes;       // per tile, its node in the union-find, -1 if no road
+    int road_tiles = 0;
+
+    NetworkChunk() { nodes.fill(-1); }
+};
+
+struct NetworkStats {
+    int road_tiles = 0;
+    int components = 0;   // separate networks
+    int splits = 0;       // removals that cut a network in two
+    int route_hits = 0;
+    int route_misses = 0;
+};
+
+// Roads on top of the tiles of a VoxelMap.
+// A road links two neighbouring tiles, every tile with at least one link is on the
+// network. Which network a tile belongs to is kept in a union-find: building a road
+// joins two networks in almost O(1). Removing one searches from both of its ends at
+// once until they meet, or until one side runs out of tiles, which is then split off
+// with a new label, so the cost is the size of the smaller side.
+// Every network has a revision, bumped whenever it changes, and routes are cached
+// against it: a route stays cached until its own network is edited.
+class TransportNetwork {
+public:
+    // Tiles of the map are only read when a road is built
+    std::map<Int2, NetworkChunk> chunks;
+
+    explicit TransportNetwork(const VoxelMap* map);
+
+    // Road between two neighbouring tiles. Returns false if they aren't neighbours,
+    // are outside the map, the slope between them is too steep or the road is already there.
+    bool add_link(Int2 a, Int2 b);
+    // Returns false if there was no such road
+    bool remove_link(Int2 a, Int2 b);
+    // Links every pair of consecutive tiles, returns how many links were built
+    int build_road(const std::vector<Int2>& tiles);
+    int remove_road(const std::vector<Int2>& tiles);
+    void clear();
+
+    uint8_t get_links(Int2 tile) const;
+    bool has_road(Int2 tile) const { return get_links(tile) != 0; }
+    bool is_connected(Int2 a, Int2 b);
+    // Tiles from a to b along the roads, both included, empty if they aren't connected.
+    // Valid until the next edit or find_route().
+    const std::vector<Int2>& find_route(Int2 a, Int2 b);
+
+    NetworkStats get_stats() const;
+
+private:
+    struct CachedRoute {
+        uint32_t revision;
+        std::vector<Int2> tiles;
+    };
+
+    const VoxelMap* map;
+    Int2 size{};
+
+    // union-find over nodes, every road tile points at one
+    std::vector<int> parent;
+    std::vector<int> component_size;         // at the root, road tiles in it
+    std::vector<uint32_t> component_revision; // at the root
+    uint32_t edits = 0;
+
+    std::unordered_map<uint64_t, CachedRoute> route_cache;
+    NetworkStats stats;
+
+    int find(int node);
+    int new_node();
+    void unite(int a, int b);
+    // Relabels every tile, once too many nodes were orphaned by splits
+    void rebuild_components();
+    // Splits the network off a, if it isn't connected to b anymore
+    void split_if_disconnected(Int2 a, Int2 b);
+
+    int* get_node(Int2 tile);
+    NetworkChunk* get_network_chunk(Int2 tile, bool create);
+    std::vector<Int2> search_route(Int2 a, Int2 b) const;
+    // Fills out with the roads out of tile
+    void get_neighbours(Int2 tile, std::vector<Int2>& out) const;
+};
+
+
+#endif //BUSINESS_GAME_TRANSPORTNETWORK_HPP
@@ -0,0 +1,314 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "path/TerrainPathfinder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <queue>
+#include <unordered_map>
+
+#define CHUNK_TILES (CHUNK_SIZE * CHUNK_SIZE)
+
+TerrainPathfinder::TerrainPathfinder(const VoxelMap* map) : map(map) {
+    chunk_count = map->get_chunk_count();
+    width = chunk_count.x * CHUNK_SIZE;
+    height = chunk_count.y * CHUNK_SIZE;
+    heights.assign(width * height, 0);
+
+    const int chunks = chunk_count.x * chunk_count.y;
+    graphs.resize(chunks);
+    east_borders.resize(chunks);
+    north_borders.resize(chunks);
+    local_dist.resize(CHUNK_TILES);
+    local_parent.resize(CHUNK_TILES);
+}
+
+void TerrainPathfinder::update() {
+    const int chunks = chunk_count.x * chunk_count.y;
+    std::vector<int> dirty;
+    for (int c = 0; c < chunks; c++) {
+        const ChunkSummary* summary = map->get_chunk_summary({c % chunk_count.x, c / chunk_count.x});
+        const unsigned int revision = summary ? summary->revision : 0;
+        if (graphs[c].built && graphs[c].revision == revision) continue;
+        dirty.emplace_back(c);
+
+        // copy the chunk's surface
+        const int x0 = (c % chunk_count.x) * CHUNK_SIZE;
+        const int y0 = (c / chunk_count.x) * CHUNK_SIZE;
+        for (int y = 0; y < CHUNK_SIZE; y++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                heights[tile_id({x0 + x, y0 + y})] = summary ? summary->get_column_height(x, y) : 0;
+            }
+        }
+        graphs[c].revision = revision;
+    }
+    stats.rebuilt_chunks = 0;
+    if (dirty.empty()) return;
+
+    // The borders on all 4 sides of a dirty chunk, and the graphs of it and its neighbours
+    std::vector<bool> affected(chunks, false);
+    for (const int c : dirty) {
+        const int cx = c % chunk_count.x, cy = c / chunk_count.x;
+        build_border(c, true);
+        build_border(c, false);
+        affected[c] = true;
+        if (cx > 0) { build_border(c - 1, true); affected[c - 1] = true; }
+        if (cy > 0) { build_border(c - chunk_count.x, false); affected[c - chunk_count.x] = true; }
+        if (cx < chunk_count.x - 1) affected[c + 1] = true;
+        if (cy < chunk_count.y - 1) affected[c + chunk_count.x] = true;
+    }
+    for (int c = 0; c < chunks; c++) {
+        if (!affected[c]) continue;
+        build_chunk_graph(c);
+        stats.rebuilt_chunks++;
+    }
+
+    stats.nodes = 0;
+    stats.edges = 0;
+    for (const ChunkGraph& graph : graphs) {
+        stats.nodes += static_cast<int>(graph.nodes.size());
+        for (const auto& edges : graph.edges) stats.edges += static_cast<int>(edges.size());
+    }
+}
+
+std::vector<Int2> TerrainPathfinder::find_path(const Int2 start, const Int2 goal) {
+    stats.expanded = 0;
+    if (!is_walkable(start) || !is_walkable(goal)) return {};
+    const int s = tile_id(start), g = tile_id(goal);
+    std::vector<Int2> path = {start};
+    if (s == g) return path;
+
+    // Same chunk: the path inside it is usually the answer
+    if (chunk_of(s) == chunk_of(g)) {
+        search_chunk(s, g);
+        if (std::isfinite(local_dist[(tile_pos(g).x % CHUNK_SIZE) + (tile_pos(g).y % CHUNK_SIZE) * CHUNK_SIZE])) {
+            append_local_path(s, g, path);
+            return path;
+        }
+    }
+
+    // Link the goal to the entrances of its chunk (steps cost the same both ways)
+    const ChunkGraph& goal_graph = graphs[chunk_of(g)];
+    std::vector<float> goal_links(goal_graph.nodes.size(), INFINITY);
+    search_chunk(g, -1);
+    for (size_t n = 0; n < goal_graph.nodes.size(); n++) {
+        const Int2 p = tile_pos(goal_graph.nodes[n]);
+        goal_links[n] = local_dist[(p.x % CHUNK_SIZE) + (p.y % CHUNK_SIZE) * CHUNK_SIZE];
+    }
+
+    // A* over the entrances, START and GOAL are two extra nodes
+    const int START = width * height, GOAL = width * height + 1;
+    auto heuristic = [&](const int id) {
+        const Int2 p = tile_pos(id);
+        return static_cast<float>(std::abs(p.x - goal.x) + std::abs(p.y - goal.y));
+    };
+    std::unordered_map<int, float> g_score;
+    std::unordered_map<int, int> parent;
+    using Open = std::pair<float, int>;
+    std::priority_queue<Open, std::vector<Open>, std::greater<>> open;
+    auto relax = [&](const int from, const int to, const float cost) {
+        const auto it = g_score.find(to);
+        if (it != g_score.end() && it->second <= cost) return;
+        g_score[to] = cost;
+        parent[to] = from;
+        open.emplace(cost + (to == GOAL ? 0.0f : heuristic(to)), to);
+    };
+
+    const ChunkGraph& start_graph = graphs[chunk_of(s)];
+    search_chunk(s, -1);
+    for (const int node : start_graph.nodes) {
+        const Int2 p = tile_pos(node);
+        const float cost = local_dist[(p.x % CHUNK_SIZE) + (p.y % CHUNK_SIZE) * CHUNK_SIZE];
+        if (std::isfinite(cost)) relax(START, node, cost);
+    }
+
+    bool found = false;
+    while (!open.empty()) {
+        const auto [f, id] = open.top();
+        open.pop();
+        if (id == GOAL) {
+            found = true;
+            break;
+        }
+        const float cost = g_score[id];
+        if (f > cost + heuristic(id) + 1e-4f) continue; // already expanded with a lower cost
+        stats.expanded++;
+
+        const ChunkGraph& graph = graphs[chunk_of(id)];
+        const int n = find_node(graph, id);
+        for (const Edge& edge : graph.edges[n]) relax(id, edge.to, cost + edge.cost);
+        if (&graph == &goal_graph && std::isfinite(goal_links[n])) relax(id, GOAL, cost + goal_links[n]);
+    }
+    if (!found) return {};
+
+    // START, entrances..., GOAL -> tiles
+    std::vector<int> waypoints;
+    for (int id = parent[GOAL]; id != START; id = parent[id]) waypoints.emplace_back(id);
+    waypoints.emplace_back(s);
+    std::reverse(waypoints.begin(), waypoints.end());
+    waypoints.emplace_back(g);
+
+    // Refine every hop: inside a chunk it is a local search, across a border a single step
+    for (size_t i = 1; i < waypoints.size(); i++) {
+        const int from = waypoints[i - 1], to = waypoints[i];
+        if (from == to) continue;
+        if (chunk_of(from) != chunk_of(to)) {
+            path.emplace_back(tile_pos(to));
+            continue;
+        }
+        search_chunk(from, to);
+        append_local_path(from, to, path);
+    }
+    return path;
+}
+
+bool TerrainPathfinder::is_walkable(const Int2 tile) const {
+    if (tile.x < 0 || tile.y < 0 || tile.x >= width || tile.y >= height) return false;
+    return heights[tile_id(tile)] > 0;
+}
+
+PathStats TerrainPathfinder::get_stats() const {
+    return stats;
+}
+
+int TerrainPathfinder::chunk_of(const int id) const {
+    const Int2 p = tile_pos(id);
+    return p.x / CHUNK_SIZE + (p.y / CHUNK_SIZE) * chunk_count.x;
+}
+
+float TerrainPathfinder::step_cost(const int from, const int to) const {
+    const int from_height = heights[from], to_height = heights[to];
+    if (from_height == 0 || to_height == 0) return -1.0f;
+    const int climb = std::abs(from_height - to_height);
+    if (climb > PATH_MAX_CLIMB) return -1.0f;
+    return 1.0f + PATH_CLIMB_COST * static_cast<float>(climb);
+}
+
+void TerrainPathfinder::build_border(const int chunk, const bool east) {
+    auto& transitions = east ? east_borders[chunk] : north_borders[chunk];
+    transitions.clear();
+    const int cx = chunk % chunk_count.x, cy = chunk / chunk_count.x;
+    if (east && cx == chunk_count.x - 1) return;
+    if (!east && cy == chunk_count.y - 1) return;
+
+    // tile i along the border, on this side and the other
+    auto inside = [&](const int i) {
+        return east ? tile_id({cx * CHUNK_SIZE + CHUNK_SIZE - 1, cy * CHUNK_SIZE + i})
+                    : tile_id({cx * CHUNK_SIZE + i, cy * CHUNK_SIZE + CHUNK_SIZE - 1});
+    };
+    auto outside = [&](const int i) {
+        return east ? inside(i) + 1 : inside(i) + width;
+    };
+
+    // every run of passable tiles is one entrance
+    int run_start = -1;
+    for (int i = 0; i <= CHUNK_SIZE; i++) {
+        const bool passable = i < CHUNK_SIZE && step_cost(inside(i), outside(i)) >= 0.0f;
+        if (passable && run_start < 0) run_start = i;
+        if (passable || run_start < 0) continue;
+
+        const int run_end = i - 1;
+        if (run_end - run_start + 1 >= PATH_ENTRANCE_SPLIT) {
+            transitions.emplace_back(Transition{inside(run_start), outside(run_start)});
+            transitions.emplace_back(Transition{inside(run_end), outside(run_end)});
+        } else {
+            const int middle = (run_start + run_end) / 2;
+            transitions.emplace_back(Transition{inside(middle), outside(middle)});
+        }
+        run_start = -1;
+    }
+}
+
+void TerrainPathfinder::build_chunk_graph(const int chunk) {
+    ChunkGraph& graph = graphs[chunk];
+    const int cx = chunk % chunk_count.x, cy = chunk / chunk_count.x;
+    const int west = cx > 0 ? chunk - 1 : -1;
+    const int south = cy > 0 ? chunk - chunk_count.x : -1;
+
+    // Every transition touching this chunk, as (tile in this chunk, tile across)
+    std::vector<std::pair<int, int>> crossings;
+    for (const Transition& t : east_borders[chunk]) crossings.emplace_back(t.inside, t.outside);
+    for (const Transition& t : north_borders[chunk]) crossings.emplace_back(t.inside, t.outside);
+    if (west >= 0) for (const Transition& t : east_borders[west]) crossings.emplace_back(t.outside, t.inside);
+    if (south >= 0) for (const Transition& t : north_borders[south]) crossings.emplace_back(t.outside, t.inside);
+
+    graph.nodes.clear();
+    for (const auto& [inside, outside] : crossings) graph.nodes.emplace_back(inside);
+    std::sort(graph.nodes.begin(), graph.nodes.end());
+    graph.nodes.erase(std::unique(graph.nodes.begin(), graph.nodes.end()), graph.nodes.end());
+
+    graph.edges.assign(graph.nodes.size(), {});
+    for (size_t n = 0; n < graph.nodes.size(); n++) {
+        search_chunk(graph.nodes[n], -1);
+        for (size_t m = 0; m < graph.nodes.size(); m++) {
+            if (m == n) continue;
+            const Int2 p = tile_pos(graph.nodes[m]);
+            const float cost = local_dist[(p.x % CHUNK_SIZE) + (p.y % CHUNK_SIZE) * CHUNK_SIZE];
+            if (std::isfinite(cost)) graph.edges[n].emplace_back(Edge{graph.nodes[m], cost});
+        }
+    }
+    for (const auto& [inside, outside] : crossings) {
+        graph.edges[find_node(graph, inside)].emplace_back(Edge{outside, step_cost(inside, outside)});
+    }
+    graph.built = true;
+}
+
+void TerrainPathfinder::search_chunk(const int from, const int to) {
+    const Int2 origin = {(tile_pos(from).x / CHUNK_SIZE) * CHUNK_SIZE, (tile_pos(from).y / CHUNK_SIZE) * CHUNK_SIZE};
+    auto local = [&](const int id) {
+        const Int2 p = tile_pos(id);
+        return (p.x - origin.x) + (p.y - origin.y) * CHUNK_SIZE;
+    };
+    std::fill(local_dist.begin(), local_dist.end(), INFINITY);
+    std::fill(local_parent.begin(), local_parent.end(), -1);
+
+    using Open = std::pair<float, int>; // cost, local tile
+    std::priority_queue<Open, std::vector<Open>, std::greater<>> open;
+    local_dist[local(from)] = 0.0f;
+    open.emplace(0.0f, local(from));
+
+    const int target = (to >= 0) ? local(to) : -1;
+    while (!open.empty()) {
+        const auto [cost, l] = open.top();
+        open.pop();
+        if (cost > local_dist[l]) continue;
+        if (l == target) return;
+
+        const int lx = l % CHUNK_SIZE, ly = l / CHUNK_SIZE;
+        const int id = tile_id({origin.x + lx, origin.y + ly});
+        const int nx[4] = {lx + 1, lx - 1, lx, lx};
+        const int ny[4] = {ly, ly, ly + 1, ly - 1};
+        for (int i = 0; i < 4; i++) {
+            if (nx[i] < 0 || ny[i] < 0 || nx[i] >= CHUNK_SIZE || ny[i] >= CHUNK_SIZE) continue;
+            const int next = tile_id({origin.x + nx[i], origin.y + ny[i]});
+            const float step = step_cost(id, next);
+            if (step < 0.0f) continue;
+
+            const int nl = nx[i] + ny[i] * CHUNK_SIZE;
+            if (cost + step >= local_dist[nl]) continue;
+            local_dist[nl] = cost + step;
+            local_parent[nl] = l;
+            open.emplace(cost + step, nl);
+        }
+    }
+}
+
+void TerrainPathfinder::append_local_path(const int from, const int to, std::vector<Int2>& path) const {
+    const Int2 origin = {(tile_pos(from).x / CHUNK_SIZE) * CHUNK_SIZE, (tile_pos(from).y / CHUNK_SIZE) * CHUNK_SIZE};
+    const Int2 from_pos = tile_pos(from), to_pos = tile_pos(to);
+    const int first = (from_pos.x - origin.x) + (from_pos.y - origin.y) * CHUNK_SIZE;
+
+    std::vector<Int2> reversed;
+    for (int l = (to_pos.x - origin.x) + (to_pos.y - origin.y) * CHUNK_SIZE; l != first && l >= 0; l = local_parent[l]) {
+        reversed.emplace_back(Int2{origin.x + l % CHUNK_SIZE, origin.y + l / CHUNK_SIZE});
+    }
+    path.insert(path.end(), reversed.rbegin(), reversed.rend());
+}
+
+int TerrainPathfinder::find_node(const ChunkGraph& graph, const int id) const {
+    const auto it = std::lower_bound(graph.nodes.begin(), graph.nodes.end(), id);
+    return static_cast<int>(it - graph.nodes.begin());
+}
@@ -0,0 +1,91 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_TERRAINPATHFINDER_HPP
+#define BUSINESS_GAME_TERRAINPATHFINDER_HPP
+#include <cstdint>
+#include <vector>
+#include "voxel/VoxelMap.hpp"
+
+#define PATH_MAX_CLIMB 1       // highest step (in voxels) between two neighbouring tiles
+#define PATH_CLIMB_COST 0.5f   // extra cost per voxel climbed (up or down)
+#define PATH_ENTRANCE_SPLIT 6  // entrances this wide get a transition at both ends, narrower ones in the middle
+
+struct PathStats {
+    int nodes = 0;          // entrance nodes in the abstract graph
+    int edges = 0;
+    int rebuilt_chunks = 0; // by the last update()
+    int expanded = 0;       // abstract nodes expanded by the last find_path()
+};
+
+// HPA* over the surface of a VoxelMap.
+// Every column (x, y) is a tile, standing on top of its highest voxel. Tiles with
+// ground can be walked between their 4 neighbours if the height difference is at most
+// PATH_MAX_CLIMB. Chunks are the clusters: where two chunks touch, every run of
+// passable tiles along their border is an entrance with one or two transition nodes,
+// and the nodes inside a chunk are linked by their shortest path through that chunk.
+// A path is found on that graph first, then refined chunk by chunk.
+// The graph of a chunk is cached against its ChunkSummary revision, so after an
+// edit only the edited chunks and their neighbours are rebuilt by update().
+class TerrainPathfinder {
+public:
+    explicit TerrainPathfinder(const VoxelMap* map);
+
+    // Rebuilds whatever changed since the last call (everything the first time)
+    void update();
+
+    // Tiles from start to goal, both included. Empty if there is no path.
+    // update() has to be called after editing the map, before this.
+    std::vector<Int2> find_path(Int2 start, Int2 goal);
+
+    bool is_walkable(Int2 tile) const;
+    PathStats get_stats() const;
+
+private:
+    struct Edge {
+        int to; // tile id
+        float cost;
+    };
+    struct ChunkGraph {
+        bool built = false;
+        unsigned int revision = 0;
+        std::vector<int> nodes;                // tile ids of the entrance tiles in this chunk
+        std::vector<std::vector<Edge>> edges;  // per node, to the chunk's other nodes and across borders
+    };
+    struct Transition {
+        int inside;  // tile in this chunk
+        int outside; // tile in the neighbour (east or north)
+    };
+
+    const VoxelMap* map;
+    Int2 chunk_count{};
+    int width = 0, height = 0; // in tiles
+    std::vector<uint8_t> heights; // surface height of every tile, 0 if there is no ground
+    std::vector<ChunkGraph> graphs;
+    std::vector<std::vector<Transition>> east_borders;  // per chunk, to the chunk at x + 1
+    std::vector<std::vector<Transition>> north_borders; // per chunk, to the chunk at y + 1
+    PathStats stats;
+
+    // scratch for search_chunk(), indexed by the tile inside the chunk
+    std::vector<float> local_dist;
+    std::vector<int> local_parent;
+
+    int tile_id(const Int2 tile) const { return tile.x + tile.y * width; }
+    Int2 tile_pos(const int id) const { return Int2{id % width, id / width}; }
+    int chunk_of(int id) const;
+    // < 0 if the step is not possible
+    float step_cost(int from, int to) const;
+
+    void build_border(int chunk, bool east);
+    void build_chunk_graph(int chunk);
+    // Dijkstra from tile `from`, without leaving its chunk, into local_dist/local_parent.
+    // Stops as soon as `to` is reached (if it is not -1).
+    void search_chunk(int from, int to);
+    // Appends the tiles after `from` up to `to`, using the last search_chunk(from, ...)
+    void append_local_path(int from, int to, std::vector<Int2>& path) const;
+    int find_node(const ChunkGraph& graph, int id) const;
+};
+
+
+#endif //BUSINESS_GAME_TERRAINPATHFINDER_HPP
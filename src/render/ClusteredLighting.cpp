@@ -0,0 +1,184 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/ClusteredLighting.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <raymath.h>
+
+ClusteredLighting::~ClusteredLighting() {
+    unload();
+}
+
+void ClusteredLighting::load(RenderBackend& backend, const Shader& shader) {
+    unload();
+    this->backend = &backend;
+
+    cluster_data = std::vector<float>(4 * CLUSTER_COUNT, 0.0f);
+    index_rows = (CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER + CLUSTER_INDEX_WIDTH - 1) / CLUSTER_INDEX_WIDTH;
+    index_data = std::vector<float>(CLUSTER_INDEX_WIDTH * index_rows, 0.0f);
+    cluster_fill = std::vector<int>(CLUSTER_COUNT, 0);
+
+    // Float textures are only read with texelFetch(), load_texture() already sets nearest filtering
+    cluster_texture = backend.load_texture(cluster_data.data(), CLUSTER_GRID_X * CLUSTER_GRID_Y, CLUSTER_GRID_Z,
+        PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    index_texture = backend.load_texture(index_data.data(), CLUSTER_INDEX_WIDTH, index_rows,
+        PIXELFORMAT_UNCOMPRESSED_R32);
+
+    cluster_data_loc     = backend.get_shader_location(shader, "clusterData");
+    cluster_indices_loc  = backend.get_shader_location(shader, "clusterIndices");
+    screen_size_loc      = backend.get_shader_location(shader, "screenSize");
+    view_dir_loc         = backend.get_shader_location(shader, "viewDir");
+    cluster_dims_loc     = backend.get_shader_location(shader, "clusterDims");
+    cluster_near_loc     = backend.get_shader_location(shader, "clusterNear");
+    cluster_scale_loc    = backend.get_shader_location(shader, "clusterScale");
+
+    TraceLog(LOG_INFO, "[ClusteredLighting] %ix%ix%i clusters, %i indices",
+        CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, CLUSTER_INDEX_WIDTH * index_rows);
+}
+
+void ClusteredLighting::unload() {
+    if (cluster_texture != 0) backend->unload_texture(cluster_texture);
+    if (index_texture != 0) backend->unload_texture(index_texture);
+    cluster_texture = index_texture = 0;
+}
+
+void ClusteredLighting::update(const std::vector<Light>& lights, const Camera3D& camera,
+    const int screen_width, const int screen_height) {
+    stats = {};
+    light_ids.clear();
+    light_ranges.clear();
+
+    const Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    view_dir = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    screen_size = Vector2{static_cast<float>(screen_width), static_cast<float>(screen_height)};
+
+    const float aspect = screen_height > 0 ? screen_size.x / screen_size.y : 1.0f;
+    const float tan_y = tanf(camera.fovy * 0.5f * DEG2RAD);
+    const float tan_x = tan_y * aspect;
+
+    // NDC (-1..1) to a tile index
+    auto toTile = [](const float ndc, const int tiles) {
+        const int t = static_cast<int>(floorf((ndc * 0.5f + 0.5f) * static_cast<float>(tiles)));
+        return std::clamp(t, 0, tiles - 1);
+    };
+
+    // 1) Find the clusters each light touches
+    for (const Light& light : lights) {
+        if (light.type != POINT_LIGHT || !light.enabled || light.radius <= 0.0f) continue;
+
+        const Vector3 vp = Vector3Transform(light.position, view);
+        const float depth = -vp.z; // view space looks down -Z
+        const float r = light.radius;
+        if (depth + r <= 0.0f) continue; // behind the camera
+
+        // Bounds of the sphere's view space box, projected over its depth range.
+        // x/d is monotonic in d, so checking both ends of the range is enough.
+        const float d_min = std::max(depth - r, 0.01f);
+        const float d_max = std::max(depth + r, 0.01f);
+        const float x_lo = std::min((vp.x - r) / d_min, (vp.x - r) / d_max) / tan_x;
+        const float x_hi = std::max((vp.x + r) / d_min, (vp.x + r) / d_max) / tan_x;
+        const float y_lo = std::min((vp.y - r) / d_min, (vp.y - r) / d_max) / tan_y;
+        const float y_hi = std::max((vp.y + r) / d_min, (vp.y + r) / d_max) / tan_y;
+        if (x_lo > 1.0f || x_hi < -1.0f || y_lo > 1.0f || y_hi < -1.0f) continue; // off screen
+
+        light_ids.push_back(light.buffer_row);
+        light_ranges.push_back(ClusterRange{
+            toTile(x_lo, CLUSTER_GRID_X), toTile(x_hi, CLUSTER_GRID_X),
+            toTile(y_lo, CLUSTER_GRID_Y), toTile(y_hi, CLUSTER_GRID_Y),
+            get_slice(depth - r), get_slice(depth + r),
+        });
+    }
+    stats.lights_binned = static_cast<int>(light_ids.size());
+
+    // 2) Count the lights per cluster (capped), then turn the counts into offsets
+    std::fill(cluster_fill.begin(), cluster_fill.end(), 0);
+    for (const ClusterRange& range : light_ranges) {
+        for (int z = range.z0; z <= range.z1; z++)
+        for (int y = range.y0; y <= range.y1; y++)
+        for (int x = range.x0; x <= range.x1; x++) {
+            int& count = cluster_fill[x + y * CLUSTER_GRID_X + z * CLUSTER_GRID_X * CLUSTER_GRID_Y];
+            if (count < MAX_LIGHTS_PER_CLUSTER) count++;
+            else stats.dropped++;
+        }
+    }
+    int offset = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++) {
+        cluster_data[c * 4 + 0] = static_cast<float>(offset);
+        cluster_data[c * 4 + 1] = static_cast<float>(cluster_fill[c]);
+        stats.max_per_cluster = std::max(stats.max_per_cluster, cluster_fill[c]);
+        offset += cluster_fill[c];
+        cluster_fill[c] = 0;
+    }
+    stats.indices = offset;
+
+    // 3) Fill the index list, in the same order so the caps drop the same lights
+    for (size_t l = 0; l < light_ranges.size(); l++) {
+        const ClusterRange& range = light_ranges[l];
+        for (int z = range.z0; z <= range.z1; z++)
+        for (int y = range.y0; y <= range.y1; y++)
+        for (int x = range.x0; x <= range.x1; x++) {
+            const int c = x + y * CLUSTER_GRID_X + z * CLUSTER_GRID_X * CLUSTER_GRID_Y;
+            const int count = static_cast<int>(cluster_data[c * 4 + 1]);
+            int& fill = cluster_fill[c];
+            if (fill >= count) continue;
+            index_data[static_cast<int>(cluster_data[c * 4 + 0]) + fill] = static_cast<float>(light_ids[l]);
+            fill++;
+        }
+    }
+
+    // 4) Upload only the rows that are in use
+    if (cluster_texture == 0) return;
+    backend->update_texture(cluster_texture, 0, 0, CLUSTER_GRID_X * CLUSTER_GRID_Y, CLUSTER_GRID_Z,
+        PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, cluster_data.data());
+    const int rows = (stats.indices + CLUSTER_INDEX_WIDTH - 1) / CLUSTER_INDEX_WIDTH;
+    if (rows > 0) {
+        backend->update_texture(index_texture, 0, 0, CLUSTER_INDEX_WIDTH, rows,
+            PIXELFORMAT_UNCOMPRESSED_R32, index_data.data());
+    }
+}
+
+void ClusteredLighting::bind(const int first_texture_unit) const {
+    const int units[2] = {first_texture_unit, first_texture_unit + 1};
+    const unsigned int textures[2] = {cluster_texture, index_texture};
+    const int locs[2] = {cluster_data_loc, cluster_indices_loc};
+    for (int i = 0; i < 2; i++) {
+        backend->bind_texture(units[i], textures[i], locs[i]);
+    }
+
+    const int dims[3] = {CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z};
+    const float scale = static_cast<float>(CLUSTER_GRID_Z) / logf(z_far / z_near);
+    backend->set_uniform(cluster_dims_loc, dims, SHADER_UNIFORM_IVEC3, 1);
+    backend->set_uniform(cluster_near_loc, &z_near, SHADER_UNIFORM_FLOAT, 1);
+    backend->set_uniform(cluster_scale_loc, &scale, SHADER_UNIFORM_FLOAT, 1);
+    backend->set_uniform(screen_size_loc, &screen_size, SHADER_UNIFORM_VEC2, 1);
+    backend->set_uniform(view_dir_loc, &view_dir, SHADER_UNIFORM_VEC3, 1);
+}
+
+ClusterStats ClusteredLighting::get_stats() const {
+    return stats;
+}
+
+size_t ClusteredLighting::get_cpu_bytes() const {
+    return (cluster_data.capacity() + index_data.capacity()) * sizeof(float)
+        + (cluster_fill.capacity() + light_ids.capacity()) * sizeof(int)
+        + light_ranges.capacity() * sizeof(ClusterRange);
+}
+
+size_t ClusteredLighting::get_gpu_bytes() const {
+    size_t bytes = 0;
+    if (cluster_texture != 0) {
+        bytes += GetPixelDataSize(CLUSTER_GRID_X * CLUSTER_GRID_Y, CLUSTER_GRID_Z, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    }
+    if (index_texture != 0) bytes += GetPixelDataSize(CLUSTER_INDEX_WIDTH, index_rows, PIXELFORMAT_UNCOMPRESSED_R32);
+    return bytes;
+}
+
+int ClusteredLighting::get_slice(const float depth) const {
+    if (depth <= z_near) return 0;
+    const float scale = static_cast<float>(CLUSTER_GRID_Z) / logf(z_far / z_near);
+    const int slice = static_cast<int>(logf(depth / z_near) * scale);
+    return std::clamp(slice, 0, CLUSTER_GRID_Z - 1);
+}
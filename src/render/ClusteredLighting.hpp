@@ -0,0 +1,93 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_CLUSTEREDLIGHTING_HPP
+#define BUSINESS_GAME_CLUSTEREDLIGHTING_HPP
+#include <raylib.h>
+#include <vector>
+#include "render/LightManager.hpp"
+
+// View frustum is split into X*Y screen tiles and Z exponential depth slices.
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+// Upper bound of the per-fragment cost
+#define MAX_LIGHTS_PER_CLUSTER 64
+// Must match CLUSTER_INDEX_WIDTH in lighting.fs
+#define CLUSTER_INDEX_WIDTH 1024
+
+struct ClusterStats {
+    int lights_binned = 0;    // lights that touch at least one cluster
+    int indices = 0;          // total light references over all clusters
+    int max_per_cluster = 0;
+    int dropped = 0;          // references dropped because a cluster was full
+};
+
+// Clustered forward lighting for point lights.
+// Every frame the CPU bins the lights into view space clusters and uploads:
+//  - per-cluster (offset, count) into the index list
+//  - the index list itself, holding rows of the LightManager's light buffer
+// The fragment shader then only loops over the lights of its own cluster.
+class ClusteredLighting {
+public:
+    // Depth range that is sliced, closer/further fragments use the first/last slice
+    float z_near = 0.5f;
+    float z_far = 100.0f;
+
+    ClusteredLighting() = default;
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    // Creates the data textures and looks up the uniform locations
+    void load(RenderBackend& backend, const Shader& shader);
+    void unload();
+
+    // Bins the enabled point lights for this camera and uploads the result
+    void update(const std::vector<Light>& lights, const Camera3D& camera,
+        int screen_width, int screen_height);
+
+    // Binds the data textures to first_texture_unit and the unit after it.
+    // The shader must already be enabled.
+    void bind(int first_texture_unit) const;
+
+    ClusterStats get_stats() const;
+    // The cluster grid and light lists
+    size_t get_cpu_bytes() const;
+    // Of the data textures
+    size_t get_gpu_bytes() const;
+
+private:
+    struct ClusterRange { int x0, x1, y0, y1, z0, z1; };
+
+    RenderBackend* backend = nullptr;
+    unsigned int cluster_texture = 0;
+    unsigned int index_texture = 0;
+    int index_rows = 0;
+
+    std::vector<float> cluster_data; // RGBA32F, (X*Y) x Z
+    std::vector<float> index_data;   // R32F, CLUSTER_INDEX_WIDTH x index_rows
+    std::vector<int> cluster_fill;
+    std::vector<int> light_ids;
+    std::vector<ClusterRange> light_ranges;
+    ClusterStats stats;
+
+    int cluster_data_loc = -1;
+    int cluster_indices_loc = -1;
+    int screen_size_loc = -1;
+    int view_dir_loc = -1;
+    int cluster_dims_loc = -1;
+    int cluster_near_loc = -1;
+    int cluster_scale_loc = -1;
+
+    Vector2 screen_size{};
+    Vector3 view_dir{};
+
+    int get_slice(float depth) const;
+};
+
+
+#endif //BUSINESS_GAME_CLUSTEREDLIGHTING_HPP
@@ -0,0 +1,90 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/Frustum.hpp"
+
+#include <cmath>
+#include <raymath.h>
+#include <rlgl.h>
+
+Frustum Frustum::from_matrix(const Matrix view_proj) {
+    // Gribb/Hartmann: rows of the clip matrix, combined
+    const Matrix& m = view_proj;
+    const Vector4 row0 = {m.m0, m.m4, m.m8,  m.m12};
+    const Vector4 row1 = {m.m1, m.m5, m.m9,  m.m13};
+    const Vector4 row2 = {m.m2, m.m6, m.m10, m.m14};
+    const Vector4 row3 = {m.m3, m.m7, m.m11, m.m15};
+
+    auto add = [](const Vector4 a, const Vector4 b) { return Vector4{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; };
+    auto sub = [](const Vector4 a, const Vector4 b) { return Vector4{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; };
+
+    Frustum frustum{};
+    frustum.planes[0] = add(row3, row0); // left
+    frustum.planes[1] = sub(row3, row0); // right
+    frustum.planes[2] = add(row3, row1); // bottom
+    frustum.planes[3] = sub(row3, row1); // top
+    frustum.planes[4] = add(row3, row2); // near
+    frustum.planes[5] = sub(row3, row2); // far
+    return frustum;
+}
+
+Frustum Frustum::from_camera(const Camera3D& camera, const float aspect) {
+    const Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    return from_matrix(MatrixMultiply(view, getCameraProjection(camera, aspect)));
+}
+
+bool Frustum::contains(const BoundingBox& box) const {
+    for (const Vector4& p : planes) {
+        // corner of the box furthest along the plane normal
+        const float x = p.x > 0.0f ? box.max.x : box.min.x;
+        const float y = p.y > 0.0f ? box.max.y : box.min.y;
+        const float z = p.z > 0.0f ? box.max.z : box.min.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool Frustum::encloses(const BoundingBox& box) const {
+    for (const Vector4& p : planes) {
+        // corner of the box furthest against the plane normal
+        const float x = p.x > 0.0f ? box.min.x : box.max.x;
+        const float y = p.y > 0.0f ? box.min.y : box.max.y;
+        const float z = p.z > 0.0f ? box.min.z : box.max.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+BoundingBox transformBoundingBox(const BoundingBox& box, const Matrix transform) {
+    BoundingBox out = {
+        Vector3{INFINITY, INFINITY, INFINITY},
+        Vector3{-INFINITY, -INFINITY, -INFINITY},
+    };
+    for (int i = 0; i < 8; i++) {
+        const Vector3 corner = {
+            (i & 1) ? box.max.x : box.min.x,
+            (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z,
+        };
+        const Vector3 t = Vector3Transform(corner, transform);
+        out.min = Vector3Min(out.min, t);
+        out.max = Vector3Max(out.max, t);
+    }
+    return out;
+}
+
+BoundingBox mergeBoundingBox(const BoundingBox& a, const BoundingBox& b) {
+    return BoundingBox{Vector3Min(a.min, b.min), Vector3Max(a.max, b.max)};
+}
+
+Matrix getCameraProjection(const Camera3D& camera, const float aspect) {
+    const double near_plane = rlGetCullDistanceNear();
+    const double far_plane = rlGetCullDistanceFar();
+    if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+        const double top = camera.fovy / 2.0;
+        const double right = top * aspect;
+        return MatrixOrtho(-right, right, -top, top, near_plane, far_plane);
+    }
+    return MatrixPerspective(camera.fovy * DEG2RAD, aspect, near_plane, far_plane);
+}
@@ -0,0 +1,32 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_FRUSTUM_HPP
+#define BUSINESS_GAME_FRUSTUM_HPP
+#include <raylib.h>
+
+// View frustum as 6 planes (a, b, c, d), normals pointing inwards.
+struct Frustum {
+    Vector4 planes[6];
+
+    // view_proj = MatrixMultiply(view, proj), same as rlgl builds the mvp
+    static Frustum from_matrix(Matrix view_proj);
+    // Same projection BeginMode3D() uses for this camera
+    static Frustum from_camera(const Camera3D& camera, float aspect);
+
+    // Conservative: may return true for boxes just outside a corner
+    bool contains(const BoundingBox& box) const;
+    // True if the whole box is inside
+    bool encloses(const BoundingBox& box) const;
+};
+
+// Axis aligned box around the 8 transformed corners of box
+BoundingBox transformBoundingBox(const BoundingBox& box, Matrix transform);
+// Grows a by b
+BoundingBox mergeBoundingBox(const BoundingBox& a, const BoundingBox& b);
+// Projection BeginMode3D() would use for this camera
+Matrix getCameraProjection(const Camera3D& camera, float aspect);
+
+
+#endif //BUSINESS_GAME_FRUSTUM_HPP
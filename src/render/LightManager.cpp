@@ -0,0 +1,226 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/LightManager.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <raymath.h>
+#include "render/Frustum.hpp"
+
+#define LIGHT_BUFFER_ROWS (MAX_LIGHTS + MAX_POINT_LIGHTS)
+#define LIGHT_ROW_FLOATS (LIGHT_BUFFER_STRIDE * 4)
+
+void Light::update() {
+    // Move light camera
+    light_camera.position = position;
+    light_camera.target = target;
+
+    shadow_view = MatrixLookAt(light_camera.position, light_camera.target, light_camera.up);
+    shadow_proj = getCameraProjection(light_camera, 1.0f);
+}
+
+// Light space only depends on the direction, so it does not move when the light does.
+// Fits the receivers in it, returns false if there are none or the light has no direction.
+static bool getLightSpace(const Light& light, const std::vector<BoundingBox>& receivers, Matrix& view, BoundingBox& fit) {
+    if (light.type != DIRECTIONAL_LIGHT || receivers.empty()) return false;
+
+    const Vector3 dir = Vector3Normalize(Vector3Subtract(light.target, light.position));
+    if (Vector3LengthSqr(dir) < 1e-6f) return false;
+    const Vector3 up = fabsf(dir.y) > 0.99f ? Vector3{0.0f, 0.0f, 1.0f} : Vector3{0.0f, 1.0f, 0.0f};
+    view = MatrixLookAt(Vector3Zero(), dir, up);
+
+    fit = transformBoundingBox(receivers[0], view);
+    for (size_t i = 1; i < receivers.size(); i++) {
+        fit = mergeBoundingBox(fit, transformBoundingBox(receivers[i], view));
+    }
+    return true;
+}
+
+bool Light::fit_shadow(const std::vector<BoundingBox>& receivers,
+    const std::vector<BoundingBox>& casters, const int resolution) {
+    Matrix view;
+    BoundingBox fit;
+    if (!getLightSpace(*this, receivers, view, fit)) return false;
+
+    // Casters between the light and the receivers still have to be in the depth range
+    float z_max = fit.max.z;
+    for (const BoundingBox& caster : casters) {
+        const BoundingBox c = transformBoundingBox(caster, view);
+        if (c.max.x < fit.min.x || c.min.x > fit.max.x || c.max.y < fit.min.y || c.min.y > fit.max.y) continue;
+        z_max = fmaxf(z_max, c.max.z);
+    }
+
+    // Square extent, rounded up in quarter octaves so it rarely changes size,
+    // then the corner is snapped to whole texels. Both stop the shadows from shimmering.
+    float size = fmaxf(fit.max.x - fit.min.x, fit.max.y - fit.min.y);
+    size += 2.0f * size / static_cast<float>(resolution);
+    size = exp2f(ceilf(log2f(fmaxf(size, 1e-3f)) * 4.0f) / 4.0f);
+    const float texel = size / static_cast<float>(resolution);
+
+    const float center_x = (fit.min.x + fit.max.x) * 0.5f;
+    const float center_y = (fit.min.y + fit.max.y) * 0.5f;
+    const float min_x = floorf((center_x - size * 0.5f) / texel) * texel;
+    const float min_y = floorf((center_y - size * 0.5f) / texel) * texel;
+
+    // View space looks down -Z, so the closest point to the light has the largest z
+    const float depth_padding = 1.0f;
+    shadow_view = view;
+    shadow_proj = MatrixOrtho(min_x, min_x + size, min_y, min_y + size,
+        -z_max - depth_padding, -fit.min.z + depth_padding);
+    return true;
+}
+
+bool Light::get_caster_frustum(const std::vector<BoundingBox>& receivers, const BoundingBox& scene, Frustum& out) const {
+    Matrix view;
+    BoundingBox fit;
+    if (!getLightSpace(*this, receivers, view, fit)) return false;
+
+    // Larger z is closer to the light, nothing in the scene is closer than its top
+    const float z_max = fmaxf(fit.max.z, transformBoundingBox(scene, view).max.z);
+    out = Frustum::from_matrix(MatrixMultiply(view,
+        MatrixOrtho(fit.min.x, fit.max.x, fit.min.y, fit.max.y, -z_max, -fit.min.z)));
+    return true;
+}
+
+LightManager::~LightManager() {
+    unload();
+}
+
+void LightManager::load(RenderBackend& backend, const Shader& shader, ShadowAtlas* shadow_atlas) {
+    unload();
+    this->backend = &backend;
+    this->shadow_atlas = shadow_atlas;
+
+    packed = std::vector<float>(LIGHT_BUFFER_ROWS * LIGHT_ROW_FLOATS, 0.0f);
+    uploaded = packed;
+    buffer_texture = backend.load_texture(uploaded.data(), LIGHT_BUFFER_STRIDE, LIGHT_BUFFER_ROWS,
+        PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+
+    light_data_loc = backend.get_shader_location(shader, "lightData");
+    light_count_loc = backend.get_shader_location(shader, "lightCount");
+}
+
+void LightManager::unload() {
+    if (buffer_texture != 0) backend->unload_texture(buffer_texture);
+    buffer_texture = 0;
+}
+
+int LightManager::create(const LightType type, const Vector3 pos, const Vector3 target, const Color color) {
+    int row;
+    if (type == DIRECTIONAL_LIGHT) {
+        if (directional_count >= MAX_LIGHTS) {
+            TraceLog(LOG_WARNING, "[Light] MAX_LIGHTS (%i) reached, light was not created", MAX_LIGHTS);
+            return -1;
+        }
+        row = directional_count++;
+    } else {
+        if (point_count >= MAX_POINT_LIGHTS) {
+            TraceLog(LOG_WARNING, "[Light] MAX_POINT_LIGHTS (%i) reached, light was not created", MAX_POINT_LIGHTS);
+            return -1;
+        }
+        row = MAX_LIGHTS + point_count++;
+    }
+
+    Light& light = lights.emplace_back();
+    light.id = next_light_id++;
+    light.enabled = true;
+    light.type = type;
+    light.position = pos;
+    light.target = target;
+    light.color = color;
+    light.buffer_row = row;
+
+    light.light_camera = {
+        light.position,
+        light.target,
+        { 0.0f, 1.0f, 0.0f },
+        32.0f,
+        CAMERA_ORTHOGRAPHIC
+    };
+
+    // Shadow Map (point lights are not shadowed)
+    if (type == DIRECTIONAL_LIGHT && shadow_atlas != nullptr) {
+        light.shadow_slot = shadow_atlas->allocate_slot();
+    }
+
+    TraceLog(LOG_DEBUG, "[Light] %u: row=%d slot=%d pos=(%.2f,%.2f,%.2f) tgt=(%.2f,%.2f,%.2f)",
+        light.id, light.buffer_row, light.shadow_slot,
+        light.position.x, light.position.y, light.position.z,
+        light.target.x, light.target.y, light.target.z);
+
+    return static_cast<int>(lights.size()) - 1;
+}
+
+void LightManager::pack(const Light& light, float* row) const {
+    const Vector3 direction = Vector3Normalize(Vector3Subtract(light.target, light.position));
+
+    row[0] = light.position.x;
+    row[1] = light.position.y;
+    row[2] = light.position.z;
+    row[3] = light.radius;
+
+    row[4] = direction.x;
+    row[5] = direction.y;
+    row[6] = direction.z;
+    row[7] = light.enabled ? 1.0f : 0.0f;
+
+    row[8]  = light.color.r / 255.0f * light.intensity;
+    row[9]  = light.color.g / 255.0f * light.intensity;
+    row[10] = light.color.b / 255.0f * light.intensity;
+    row[11] = static_cast<float>(light.shadow_slot);
+}
+
+void LightManager::upload() {
+    upload_stats = {};
+    for (const Light& light : lights) {
+        pack(light, &packed[light.buffer_row * LIGHT_ROW_FLOATS]);
+    }
+    if (buffer_texture == 0) return;
+
+    // Walk the rows in use, sending every run of changed rows in one call
+    auto uploadRange = [&](const int first, const int last) {
+        const size_t offset = first * LIGHT_ROW_FLOATS;
+        const size_t count = (last - first) * LIGHT_ROW_FLOATS;
+        backend->update_texture(buffer_texture, 0, first, LIGHT_BUFFER_STRIDE, last - first,
+            PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, &packed[offset]);
+        std::memcpy(&uploaded[offset], &packed[offset], count * sizeof(float));
+        upload_stats.rows += last - first;
+        upload_stats.ranges++;
+    };
+    auto uploadChanged = [&](const int begin, const int end) {
+        int run_start = -1;
+        for (int row = begin; row < end; row++) {
+            const size_t offset = row * LIGHT_ROW_FLOATS;
+            const bool changed = std::memcmp(&packed[offset], &uploaded[offset],
+                LIGHT_ROW_FLOATS * sizeof(float)) != 0;
+            if (changed && run_start < 0) run_start = row;
+            if (!changed && run_start >= 0) {
+                uploadRange(run_start, row);
+                run_start = -1;
+            }
+        }
+        if (run_start >= 0) uploadRange(run_start, end);
+    };
+    uploadChanged(0, directional_count);
+    uploadChanged(MAX_LIGHTS, MAX_LIGHTS + point_count);
+}
+
+void LightManager::bind(const int texture_unit) const {
+    backend->bind_texture(texture_unit, buffer_texture, light_data_loc);
+    backend->set_uniform(light_count_loc, &directional_count, SHADER_UNIFORM_INT);
+}
+
+LightUploadStats LightManager::get_upload_stats() const {
+    return upload_stats;
+}
+
+size_t LightManager::get_cpu_bytes() const {
+    return lights.capacity() * sizeof(Light) + (packed.capacity() + uploaded.capacity()) * sizeof(float);
+}
+
+size_t LightManager::get_gpu_bytes() const {
+    if (buffer_texture == 0) return 0;
+    return GetPixelDataSize(LIGHT_BUFFER_STRIDE, LIGHT_BUFFER_ROWS, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+}
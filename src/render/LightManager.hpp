@@ -0,0 +1,123 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_LIGHTMANAGER_HPP
+#define BUSINESS_GAME_LIGHTMANAGER_HPP
+#include <raylib.h>
+#include <vector>
+#include "render/ShadowAtlas.hpp"
+#include "render/Frustum.hpp"
+
+// Must match MAX_LIGHTS in lighting.fs
+// Directional lights, every fragment loops over all of them
+#define MAX_LIGHTS 16
+// Point lights, only looped over per cluster (see ClusteredLighting)
+#define MAX_POINT_LIGHTS 1024
+// Texels per light in the light buffer
+#define LIGHT_BUFFER_STRIDE 3
+
+// Light data
+// taken from https://github.com/raysan5/raylib/blob/fbdf5e4fd2cb2ddd37d81e1c499797f3a2801ab5/examples/models/rlights.h#L46
+enum LightType {
+    DIRECTIONAL_LIGHT = 0,
+    POINT_LIGHT = 1,
+};
+
+struct Light {
+    unsigned int id{};
+    int type{};
+    bool enabled{true};
+    Vector3 position{};
+    Vector3 target{};  // only used by directional lights
+    Color color{WHITE};
+    float intensity{1.0f};
+    float radius{2.0f}; // only used by point lights
+
+    Camera3D light_camera{}; // fallback shadow frustum, when it is not fitted
+    int shadow_slot{-1}; // tile in the shadow atlas, -1 if the light casts no shadows
+    float shadow_importance{1.0f}; // higher gets its shadow map updated more often (see ShadowScheduler)
+    Matrix shadow_view{}; // used for the next shadow pass
+    Matrix shadow_proj{};
+    Matrix light_view_proj{}; // used for the last shadow pass
+    int buffer_row{-1};  // row of this light in the light buffer
+
+    // Moves the light camera and resets the shadow frustum to it.
+    // Nothing is sent to the shader here.
+    void update();
+
+    // Directional lights only: fits an orthographic shadow frustum around the receivers
+    // (and the casters in front of them), snapped to whole texels of a resolution sized map.
+    // Returns false (and leaves the frustum as it is) if there is nothing to fit.
+    bool fit_shadow(const std::vector<BoundingBox>& receivers,
+        const std::vector<BoundingBox>& casters, int resolution);
+    // Directional lights only: the receivers' extent seen from the light, stretched towards it
+    // until it leaves scene. Everything that can shadow the receivers is inside it.
+    // Returns false if there are no receivers.
+    bool get_caster_frustum(const std::vector<BoundingBox>& receivers, const BoundingBox& scene, Frustum& out) const;
+};
+
+struct LightUploadStats {
+    int rows = 0;   // rows sent to the GPU this frame
+    int ranges = 0; // driver calls this frame
+};
+
+// Owns every light and packs them into one float texture (the light buffer),
+// LIGHT_BUFFER_STRIDE texels per row:
+//  0: position, radius
+//  1: direction (normalized target - position), enabled
+//  2: colour * intensity, shadow slot
+// Rows [0, MAX_LIGHTS) hold the directional lights, the point lights follow.
+// Every frame the rows are packed on the CPU and compared against what was
+// last uploaded, only the changed ranges of rows are sent.
+class LightManager {
+public:
+    std::vector<Light> lights;
+
+    LightManager() = default;
+    ~LightManager();
+
+    LightManager(const LightManager&) = delete;
+    LightManager& operator=(const LightManager&) = delete;
+
+    // Creates the light buffer. Directional lights created afterwards get a slot in shadow_atlas.
+    void load(RenderBackend& backend, const Shader& shader, ShadowAtlas* shadow_atlas);
+    void unload();
+
+    // Factory: creates, initializes, registers, and returns the index of the Light.
+    // Returns -1 if there is no row left for this type of light.
+    int create(LightType type, Vector3 pos, Vector3 target, Color color);
+
+    // Packs every light and uploads the rows that changed
+    void upload();
+
+    // Binds the light buffer to texture_unit and sets the light counts.
+    // The shader must already be enabled.
+    void bind(int texture_unit) const;
+
+    LightUploadStats get_upload_stats() const;
+    // The lights and their packed rows
+    size_t get_cpu_bytes() const;
+    // Of the light buffer
+    size_t get_gpu_bytes() const;
+
+private:
+    RenderBackend* backend = nullptr;
+    unsigned int buffer_texture = 0;
+    ShadowAtlas* shadow_atlas = nullptr;
+    unsigned int next_light_id = 0;
+    int directional_count = 0;
+    int point_count = 0;
+
+    std::vector<float> packed;   // this frame
+    std::vector<float> uploaded; // last sent to the GPU
+    LightUploadStats upload_stats;
+
+    int light_data_loc = -1;
+    int light_count_loc = -1;
+
+    void pack(const Light& light, float* row) const;
+};
+
+
+#endif //BUSINESS_GAME_LIGHTMANAGER_HPP
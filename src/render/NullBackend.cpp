@@ -0,0 +1,94 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/NullBackend.hpp"
+
+#include <rlgl.h>
+#include "voxel/VoxelMesher.hpp"
+
+void NullBackend::open(const int width, const int height, const char* title) {
+    this->width = width;
+    this->height = height;
+    frame_stats = last_frame_stats = total_stats = {};
+    TraceLog(LOG_INFO, "[NullBackend] \"%s\" at %ix%i, nothing will be drawn", title, width, height);
+}
+
+void NullBackend::upload_mesh(Mesh& mesh, bool /*dynamic*/) {
+    // vaoId stays 0, so it still looks like a mesh that was never uploaded
+    frame_stats.mesh_uploads++;
+    frame_stats.uploaded_bytes += get_mesh_bytes(mesh);
+}
+
+void NullBackend::unload_mesh(Mesh& mesh) {
+    // never uploaded, UnloadMesh() only frees the CPU copy
+    UnloadMesh(mesh);
+}
+
+void NullBackend::unload_model(Model& model) {
+    UnloadModel(model);
+}
+
+Material NullBackend::load_material_default() {
+    // only allocates the maps, the default shader and texture ids are 0 without a GL context
+    return LoadMaterialDefault();
+}
+
+Shader NullBackend::load_shader(const char* /*vertex_code*/, const char* /*fragment_code*/) {
+    Shader shader{};
+    shader.id = next_id++;
+    shader.locs = static_cast<int*>(MemAlloc(RL_MAX_SHADER_LOCATIONS * sizeof(int)));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+    return shader;
+}
+
+unsigned int NullBackend::load_texture(const void* /*data*/, const int width, const int height, const int format) {
+    frame_stats.uploaded_bytes += GetPixelDataSize(width, height, format);
+    return next_id++;
+}
+
+void NullBackend::update_texture(unsigned int /*texture*/, int /*x*/, int /*y*/, const int width, const int height,
+    const int format, const void* /*data*/) {
+    frame_stats.uploaded_bytes += GetPixelDataSize(width, height, format);
+}
+
+RenderTexture2D NullBackend::load_depth_target(const int width, const int height) {
+    RenderTexture2D target{};
+    target.id = next_id++;
+    target.texture.width = width;
+    target.texture.height = height;
+    target.depth.id = next_id++;
+    target.depth.width = width;
+    target.depth.height = height;
+    target.depth.mipmaps = 1;
+    return target;
+}
+
+void NullBackend::begin_frame(Color /*clear*/) {
+    draws.clear();
+}
+
+void NullBackend::end_frame() {
+    // the uploads made before begin_frame() count for this frame too
+    frame_stats.frames = 1;
+    last_frame_stats = frame_stats;
+    total_stats.frames++;
+    total_stats.passes += frame_stats.passes;
+    total_stats.draw_calls += frame_stats.draw_calls;
+    total_stats.triangles += frame_stats.triangles;
+    total_stats.vertices += frame_stats.vertices;
+    total_stats.mesh_uploads += frame_stats.mesh_uploads;
+    total_stats.uploaded_bytes += frame_stats.uploaded_bytes;
+    frame_stats = {};
+    last_draws.swap(draws);
+}
+
+void NullBackend::draw_mesh(const Mesh& mesh, const Material& material, const Matrix& transform) {
+    frame_stats.draw_calls++;
+    frame_stats.triangles += mesh.triangleCount;
+    frame_stats.vertices += mesh.vertexCount;
+    if (record_draws) {
+        draws.emplace_back(DrawRecord{frame_stats.passes - 1, material.shader.id,
+            mesh.vertexCount, mesh.triangleCount, transform});
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_NULLBACKEND_HPP
+#define BUSINESS_GAME_NULLBACKEND_HPP
+#include <vector>
+#include "render/RenderBackend.hpp"
+
+struct RenderStats {
+    int frames = 0;
+    int passes = 0;          // begin_camera() and begin_view() calls
+    int draw_calls = 0;
+    long long triangles = 0;
+    long long vertices = 0;
+    int mesh_uploads = 0;
+    size_t uploaded_bytes = 0; // meshes and textures
+};
+
+// A draw_mesh() call, recorded by NullBackend
+struct DrawRecord {
+    int pass;                // index of the frame's begin_camera()/begin_view()
+    unsigned int shader;     // of the material
+    int vertex_count;
+    int triangle_count;
+    Matrix transform;
+};
+
+// Draws nothing and needs no GL context, so the whole frame (updates, culling, meshing
+// and the draw calls) can run on machines without a GPU. Meshes stay in CPU memory,
+// textures, shaders and framebuffers get made up ids. Everything it is asked to do is
+// counted, and with record_draws set the draw calls of the last frame are kept too.
+class NullBackend final : public RenderBackend {
+public:
+    bool record_draws = false;
+
+    void open(int width, int height, const char* title) override;
+    void close() override {}
+    int get_render_width() const override { return width; }
+    int get_render_height() const override { return height; }
+    bool is_headless() const override { return true; }
+
+    void upload_mesh(Mesh& mesh, bool dynamic) override;
+    void unload_mesh(Mesh& mesh) override;
+    void unload_model(Model& model) override;
+    Material load_material_default() override;
+
+    Shader load_shader(const char* vertex_code, const char* fragment_code) override;
+    int get_shader_location(const Shader& /*shader*/, const char* /*name*/) override { return -1; }
+    void set_shader_value(const Shader& /*shader*/, int /*loc*/, const void* /*value*/, int /*type*/, int /*count*/) override {}
+    void enable_shader(const Shader& /*shader*/) override {}
+    void set_uniform(int /*loc*/, const void* /*value*/, int /*type*/, int /*count*/) override {}
+    void set_uniform_matrices(int /*loc*/, const Matrix* /*matrices*/, int /*count*/) override {}
+
+    unsigned int load_texture(const void* data, int width, int height, int format) override;
+    void update_texture(unsigned int texture, int x, int y, int width, int height, int format, const void* data) override;
+    void unload_texture(unsigned int /*texture*/) override {}
+    void bind_texture(int /*unit*/, unsigned int /*texture*/, int /*loc*/) override {}
+    RenderTexture2D load_depth_target(int width, int height) override;
+    void unload_render_target(RenderTexture2D& target) override { target = {}; }
+
+    void begin_frame(Color clear) override;
+    void end_frame() override;
+    void begin_target(const RenderTexture2D& /*target*/) override {}
+    void end_target() override {}
+    void begin_viewport(Rectangle /*rect*/) override {}
+    void end_viewport() override {}
+    void begin_camera(const Camera3D& /*camera*/) override { frame_stats.passes++; }
+    void end_camera() override {}
+    void begin_view(Matrix /*view*/, Matrix /*projection*/) override { frame_stats.passes++; }
+    void end_view() override {}
+
+    void draw_mesh(const Mesh& mesh, const Material& material, const Matrix& transform) override;
+
+    // Of the last frame that was ended
+    const RenderStats& get_frame_stats() const { return last_frame_stats; }
+    // Since open()
+    const RenderStats& get_total_stats() const { return total_stats; }
+    // draw_mesh() calls of the last frame that was ended, empty unless record_draws is set
+    const std::vector<DrawRecord>& get_draws() const { return last_draws; }
+
+private:
+    int width = 0, height = 0;
+    unsigned int next_id = 1;
+    RenderStats frame_stats, last_frame_stats, total_stats;
+    std::vector<DrawRecord> draws, last_draws;
+};
+
+
+#endif //BUSINESS_GAME_NULLBACKEND_HPP
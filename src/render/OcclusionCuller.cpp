@@ -0,0 +1,163 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <raymath.h>
+
+// Clip space w under which a corner counts as behind the camera
+#define OCCLUSION_MIN_W 0.001f
+
+// Corner i of a box, bit 0: x, bit 1: y, bit 2: z
+static Vector3 getBoxCorner(const BoundingBox& box, const int i) {
+    return Vector3{
+        (i & 1) ? box.max.x : box.min.x,
+        (i & 2) ? box.max.y : box.min.y,
+        (i & 4) ? box.max.z : box.min.z,
+    };
+}
+
+// The 12 triangles of a box, as corner indices
+static constexpr int BOX_TRIANGLES[12][3] = {
+    {0, 2, 3}, {0, 3, 1}, // -Z
+    {4, 5, 7}, {4, 7, 6}, // +Z
+    {0, 4, 6}, {0, 6, 2}, // -X
+    {1, 3, 7}, {1, 7, 5}, // +X
+    {0, 1, 5}, {0, 5, 4}, // -Y
+    {2, 6, 7}, {2, 7, 3}, // +Y
+};
+
+OcclusionCuller::OcclusionCuller() :
+    depth(OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT, 1.0f) {}
+
+void OcclusionCuller::begin(const Matrix& view_proj) {
+    this->view_proj = view_proj;
+    std::fill(depth.begin(), depth.end(), 1.0f);
+    stats = {};
+}
+
+void OcclusionCuller::add_occluder(const BoundingBox& box, const Matrix& model_matrix) {
+    const Matrix mvp = MatrixMultiply(model_matrix, view_proj);
+
+    ScreenVertex corners[8];
+    for (int i = 0; i < 8; i++) {
+        if (!project(mvp, getBoxCorner(box, i), corners[i])) return;
+    }
+    rasterise_box(corners);
+    stats.occluders++;
+}
+
+bool OcclusionCuller::is_visible(const BoundingBox& box) {
+    stats.tested++;
+
+    float min_x = INFINITY, min_y = INFINITY, min_z = INFINITY;
+    float max_x = -INFINITY, max_y = -INFINITY;
+    for (int i = 0; i < 8; i++) {
+        ScreenVertex v{};
+        if (!project(view_proj, getBoxCorner(box, i), v)) return true;
+        min_x = std::min(min_x, v.x);
+        min_y = std::min(min_y, v.y);
+        min_z = std::min(min_z, v.z);
+        max_x = std::max(max_x, v.x);
+        max_y = std::max(max_y, v.y);
+    }
+
+    // Every pixel the box might touch
+    const int x0 = std::max(static_cast<int>(std::floor(min_x)), 0);
+    const int y0 = std::max(static_cast<int>(std::floor(min_y)), 0);
+    const int x1 = std::min(static_cast<int>(std::floor(max_x)), OCCLUSION_BUFFER_WIDTH - 1);
+    const int y1 = std::min(static_cast<int>(std::floor(max_y)), OCCLUSION_BUFFER_HEIGHT - 1);
+    if (x0 > x1 || y0 > y1) return true; // off screen, leave it to the frustum
+
+    for (int y = y0; y <= y1; y++) {
+        const float* row = &depth[y * OCCLUSION_BUFFER_WIDTH];
+        for (int x = x0; x <= x1; x++) {
+            if (min_z <= row[x]) return true;
+        }
+    }
+    stats.rejected++;
+    return false;
+}
+
+OcclusionStats OcclusionCuller::get_stats() const {
+    return stats;
+}
+
+bool OcclusionCuller::project(const Matrix& mvp, const Vector3 v, ScreenVertex& out) {
+    const float x = mvp.m0 * v.x + mvp.m4 * v.y + mvp.m8 * v.z + mvp.m12;
+    const float y = mvp.m1 * v.x + mvp.m5 * v.y + mvp.m9 * v.z + mvp.m13;
+    const float z = mvp.m2 * v.x + mvp.m6 * v.y + mvp.m10 * v.z + mvp.m14;
+    const float w = mvp.m3 * v.x + mvp.m7 * v.y + mvp.m11 * v.z + mvp.m15;
+    if (w < OCCLUSION_MIN_W) return false;
+
+    // NDC -> buffer pixels, depth 0..1 (y is up, it only has to match between the two)
+    out.x = (x / w * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+    out.y = (y / w * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+    out.z = z / w * 0.5f + 0.5f;
+    return true;
+}
+
+void OcclusionCuller::rasterise_box(const ScreenVertex (&corners)[8]) {
+    // Pixel corners inside the box's outline, x in [x0, x1] and y in [y0, y1]
+    float min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    for (const ScreenVertex& v : corners) {
+        min_x = std::min(min_x, v.x);
+        min_y = std::min(min_y, v.y);
+        max_x = std::max(max_x, v.x);
+        max_y = std::max(max_y, v.y);
+    }
+    const int x0 = std::max(static_cast<int>(std::ceil(min_x)), 0);
+    const int y0 = std::max(static_cast<int>(std::ceil(min_y)), 0);
+    const int x1 = std::min(static_cast<int>(std::floor(max_x)), OCCLUSION_BUFFER_WIDTH);
+    const int y1 = std::min(static_cast<int>(std::floor(max_y)), OCCLUSION_BUFFER_HEIGHT);
+    if (x1 <= x0 || y1 <= y0) return; // doesn't fill a single pixel
+
+    // Depth of the box's front at every pixel corner, INFINITY outside of it.
+    // The nearest of the triangles over a corner is the front, the back ones are further.
+    const int columns = x1 - x0 + 1;
+    corner_depth.assign(static_cast<size_t>(columns) * (y1 - y0 + 1), INFINITY);
+    for (const auto& tri : BOX_TRIANGLES) {
+        const ScreenVertex& a = corners[tri[0]];
+        const ScreenVertex& b = corners[tri[1]];
+        const ScreenVertex& c = corners[tri[2]];
+        const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (std::fabs(area) < 1e-6f) continue; // edge on, the faces around it cover it
+        const float inv_area = 1.0f / area;
+
+        const int tx0 = std::max(static_cast<int>(std::ceil(std::min({a.x, b.x, c.x}))), x0);
+        const int ty0 = std::max(static_cast<int>(std::ceil(std::min({a.y, b.y, c.y}))), y0);
+        const int tx1 = std::min(static_cast<int>(std::floor(std::max({a.x, b.x, c.x}))), x1);
+        const int ty1 = std::min(static_cast<int>(std::floor(std::max({a.y, b.y, c.y}))), y1);
+        for (int y = ty0; y <= ty1; y++) {
+            const float py = static_cast<float>(y);
+            float* row = &corner_depth[static_cast<size_t>(y - y0) * columns];
+            for (int x = tx0; x <= tx1; x++) {
+                const float px = static_cast<float>(x);
+                const float w0 = ((b.x - px) * (c.y - py) - (b.y - py) * (c.x - px)) * inv_area;
+                const float w1 = ((c.x - px) * (a.y - py) - (c.y - py) * (a.x - px)) * inv_area;
+                const float w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+                // z is linear in screen space
+                const float z = w0 * a.z + w1 * b.z + w2 * c.z;
+                row[x - x0] = std::min(row[x - x0], z);
+            }
+        }
+    }
+
+    // The box is convex, so a pixel whose 4 corners are inside it is covered completely,
+    // and the front is convex too: its farthest point in the pixel is at one of the corners.
+    for (int y = y0; y < y1; y++) {
+        const float* top = &corner_depth[static_cast<size_t>(y - y0) * columns];
+        const float* bottom = top + columns;
+        float* row = &depth[y * OCCLUSION_BUFFER_WIDTH];
+        for (int x = x0; x < x1; x++) {
+            const int i = x - x0;
+            const float z = std::max({top[i], top[i + 1], bottom[i], bottom[i + 1]});
+            if (z >= 0.0f && z < row[x]) row[x] = z;
+        }
+    }
+}
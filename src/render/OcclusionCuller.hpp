@@ -0,0 +1,59 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_OCCLUSIONCULLER_HPP
+#define BUSINESS_GAME_OCCLUSIONCULLER_HPP
+#include <raylib.h>
+#include <vector>
+
+// Size of the software depth buffer, it only has to be big enough to catch whole chunks
+#define OCCLUSION_BUFFER_WIDTH 256
+#define OCCLUSION_BUFFER_HEIGHT 144
+
+struct OcclusionStats {
+    int occluders = 0; // boxes rasterised into the depth buffer
+    int tested = 0;    // bounding boxes tested against it
+    int rejected = 0;  // of those, fully hidden
+};
+
+// CPU occlusion culling.
+// Every frame a few solid boxes (occluders, see build_chunk_occluders()) are
+// rasterised into a small depth buffer, then the bounding box of every chunk
+// is tested against it: if each pixel it covers already has something nearer,
+// the chunk is hidden behind the terrain and doesn't need to be drawn.
+// Anything crossing the near plane is kept (and not used as an occluder).
+// It errs on the side of drawing: occluders only cover the pixels they fill completely,
+// with the farthest depth they have in them. `--bench occlusion` checks nothing visible is culled.
+class OcclusionCuller {
+public:
+    OcclusionCuller();
+
+    // Clears the depth buffer, view_proj is the camera's view * projection
+    void begin(const Matrix& view_proj);
+
+    // box is in model space, it must be completely solid
+    void add_occluder(const BoundingBox& box, const Matrix& model_matrix);
+
+    // box is in world space. Returns false if it is hidden by the occluders
+    bool is_visible(const BoundingBox& box);
+
+    OcclusionStats get_stats() const;
+
+private:
+    struct ScreenVertex {
+        float x, y, z;
+    };
+
+    std::vector<float> depth; // 0 near .. 1 far, OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT
+    std::vector<float> corner_depth; // scratch for rasterise_box()
+    Matrix view_proj{};
+    OcclusionStats stats;
+
+    // false if the point is behind (or too close to) the camera
+    static bool project(const Matrix& mvp, Vector3 v, ScreenVertex& out);
+    void rasterise_box(const ScreenVertex (&corners)[8]);
+};
+
+
+#endif //BUSINESS_GAME_OCCLUSIONCULLER_HPP
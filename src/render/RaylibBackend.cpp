@@ -0,0 +1,180 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/RaylibBackend.hpp"
+
+#include <rlgl.h>
+
+void RaylibBackend::open(const int width, const int height, const char* title) {
+    SetConfigFlags(FLAG_MSAA_4X_HINT);  // Enable Multi Sampling Anti Aliasing 4x (if available)
+    InitWindow(width, height, title);
+}
+
+void RaylibBackend::close() {
+    CloseWindow();
+}
+
+int RaylibBackend::get_render_width() const {
+    return GetRenderWidth();
+}
+
+int RaylibBackend::get_render_height() const {
+    return GetRenderHeight();
+}
+
+void RaylibBackend::upload_mesh(Mesh& mesh, const bool dynamic) {
+    UploadMesh(&mesh, dynamic);
+}
+
+void RaylibBackend::unload_mesh(Mesh& mesh) {
+    UnloadMesh(mesh);
+}
+
+void RaylibBackend::unload_model(Model& model) {
+    UnloadModel(model);
+}
+
+Material RaylibBackend::load_material_default() {
+    return LoadMaterialDefault();
+}
+
+Shader RaylibBackend::load_shader(const char* vertex_code, const char* fragment_code) {
+    return LoadShaderFromMemory(vertex_code, fragment_code);
+}
+
+int RaylibBackend::get_shader_location(const Shader& shader, const char* name) {
+    return GetShaderLocation(shader, name);
+}
+
+void RaylibBackend::set_shader_value(const Shader& shader, const int loc, const void* value, const int type, const int count) {
+    SetShaderValueV(shader, loc, value, type, count);
+}
+
+void RaylibBackend::enable_shader(const Shader& shader) {
+    rlEnableShader(shader.id);
+}
+
+void RaylibBackend::set_uniform(const int loc, const void* value, const int type, const int count) {
+    rlSetUniform(loc, value, type, count);
+}
+
+void RaylibBackend::set_uniform_matrices(const int loc, const Matrix* matrices, const int count) {
+    rlSetUniformMatrices(loc, matrices, count);
+}
+
+unsigned int RaylibBackend::load_texture(const void* data, const int width, const int height, const int format) {
+    return rlLoadTexture(data, width, height, format, 1);
+}
+
+void RaylibBackend::update_texture(const unsigned int texture, const int x, const int y, const int width, const int height,
+    const int format, const void* data) {
+    rlUpdateTexture(texture, x, y, width, height, format, data);
+}
+
+void RaylibBackend::unload_texture(const unsigned int texture) {
+    rlUnloadTexture(texture);
+}
+
+void RaylibBackend::bind_texture(const int unit, const unsigned int texture, const int loc) {
+    rlActiveTextureSlot(unit);
+    rlEnableTexture(texture);
+    rlSetUniform(loc, &unit, RL_SHADER_UNIFORM_INT, 1);
+}
+
+RenderTexture2D RaylibBackend::load_depth_target(const int width, const int height) {
+    RenderTexture2D target{};
+    const unsigned int fbo = rlLoadFramebuffer(); // load an empty framebuffer
+    target.id = fbo;
+    target.texture.width = width;
+    target.texture.height = height;
+    if (fbo == 0) {
+        TraceLog(LOG_WARNING, "FBO: Depth framebuffer object can not be created!");
+        return target;
+    }
+    rlEnableFramebuffer(fbo);
+
+    // Create depth texture
+    target.depth.id = rlLoadTextureDepth(width, height, false);
+    target.depth.width = width;
+    target.depth.height = height;
+    target.depth.mipmaps = 1;
+
+    // Attach depth texture to framebuffer
+    rlFramebufferAttach(fbo, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+
+    // Check if framebuffer is complete with attachments
+    if (rlFramebufferComplete(fbo))
+        TraceLog(LOG_INFO, "FBO: [ID %i] Depth framebuffer created successfully (%ix%i)", fbo, width, height);
+    else
+        TraceLog(LOG_WARNING, "FBO: [ID %i] Depth framebuffer created unsuccessfully", fbo);
+
+    rlDisableFramebuffer();
+    return target;
+}
+
+void RaylibBackend::unload_render_target(RenderTexture2D& target) {
+    if (target.id == 0) return;
+    rlUnloadTexture(target.depth.id);
+    rlUnloadFramebuffer(target.id);
+    target = {};
+}
+
+void RaylibBackend::begin_frame(const Color clear) {
+    BeginDrawing();
+    ClearBackground(clear);
+}
+
+void RaylibBackend::end_frame() {
+    EndDrawing();
+}
+
+void RaylibBackend::begin_target(const RenderTexture2D& target) {
+    BeginTextureMode(target);
+}
+
+void RaylibBackend::end_target() {
+    EndTextureMode();
+}
+
+void RaylibBackend::begin_viewport(const Rectangle rect) {
+    // flush anything drawn into the previous viewport
+    rlDrawRenderBatchActive();
+
+    const int x = static_cast<int>(rect.x), y = static_cast<int>(rect.y);
+    const int width = static_cast<int>(rect.width), height = static_cast<int>(rect.height);
+    rlViewport(x, y, width, height);
+
+    // glClear ignores the viewport, the scissor keeps the rest of the target intact
+    rlEnableScissorTest();
+    rlScissor(x, y, width, height);
+    rlClearScreenBuffers();
+}
+
+void RaylibBackend::end_viewport() {
+    rlDrawRenderBatchActive();
+    rlDisableScissorTest();
+}
+
+void RaylibBackend::begin_camera(const Camera3D& camera) {
+    BeginMode3D(camera);
+}
+
+void RaylibBackend::end_camera() {
+    EndMode3D();
+}
+
+void RaylibBackend::begin_view(const Matrix view, const Matrix projection) {
+    rlSetMatrixProjection(projection);
+    rlSetMatrixModelview(view);
+    rlEnableDepthTest();
+}
+
+void RaylibBackend::end_view() {
+    rlDrawRenderBatchActive();
+    rlDisableDepthTest();
+}
+
+void RaylibBackend::draw_mesh(const Mesh& mesh, const Material& material, const Matrix& transform) {
+    DrawMesh(mesh, material, transform);
+}
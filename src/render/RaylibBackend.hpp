@@ -0,0 +1,52 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_RAYLIBBACKEND_HPP
+#define BUSINESS_GAME_RAYLIBBACKEND_HPP
+#include "render/RenderBackend.hpp"
+
+// Straight through to raylib and rlgl, needs the window (and its GL context) from open()
+class RaylibBackend final : public RenderBackend {
+public:
+    void open(int width, int height, const char* title) override;
+    void close() override;
+    int get_render_width() const override;
+    int get_render_height() const override;
+    bool is_headless() const override { return false; }
+
+    void upload_mesh(Mesh& mesh, bool dynamic) override;
+    void unload_mesh(Mesh& mesh) override;
+    void unload_model(Model& model) override;
+    Material load_material_default() override;
+
+    Shader load_shader(const char* vertex_code, const char* fragment_code) override;
+    int get_shader_location(const Shader& shader, const char* name) override;
+    void set_shader_value(const Shader& shader, int loc, const void* value, int type, int count) override;
+    void enable_shader(const Shader& shader) override;
+    void set_uniform(int loc, const void* value, int type, int count) override;
+    void set_uniform_matrices(int loc, const Matrix* matrices, int count) override;
+
+    unsigned int load_texture(const void* data, int width, int height, int format) override;
+    void update_texture(unsigned int texture, int x, int y, int width, int height, int format, const void* data) override;
+    void unload_texture(unsigned int texture) override;
+    void bind_texture(int unit, unsigned int texture, int loc) override;
+    RenderTexture2D load_depth_target(int width, int height) override;
+    void unload_render_target(RenderTexture2D& target) override;
+
+    void begin_frame(Color clear) override;
+    void end_frame() override;
+    void begin_target(const RenderTexture2D& target) override;
+    void end_target() override;
+    void begin_viewport(Rectangle rect) override;
+    void end_viewport() override;
+    void begin_camera(const Camera3D& camera) override;
+    void end_camera() override;
+    void begin_view(Matrix view, Matrix projection) override;
+    void end_view() override;
+
+    void draw_mesh(const Mesh& mesh, const Material& material, const Matrix& transform) override;
+};
+
+
+#endif //BUSINESS_GAME_RAYLIBBACKEND_HPP
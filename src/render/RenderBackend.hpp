@@ -0,0 +1,71 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_RENDERBACKEND_HPP
+#define BUSINESS_GAME_RENDERBACKEND_HPP
+#include <raylib.h>
+
+// Every GPU call of the game goes through one of these (global::render_backend),
+// so the same frame can run on raylib or with nothing drawn at all (NullBackend).
+// The functions are the raylib/rlgl calls they stand for, the names say which.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    // Window
+    virtual void open(int width, int height, const char* title) = 0;
+    virtual void close() = 0;
+    virtual int get_render_width() const = 0;
+    virtual int get_render_height() const = 0;
+    // Nothing is drawn, so raylib's immediate mode (DrawCube(), DrawText()...) can't be used either
+    virtual bool is_headless() const = 0;
+
+    // Meshes and materials
+    virtual void upload_mesh(Mesh& mesh, bool dynamic) = 0;
+    // Frees the GPU buffers (if the mesh was uploaded) and the CPU copy
+    virtual void unload_mesh(Mesh& mesh) = 0;
+    // Frees the meshes and the material maps, not the shaders
+    virtual void unload_model(Model& model) = 0;
+    virtual Material load_material_default() = 0;
+
+    // Shaders
+    virtual Shader load_shader(const char* vertex_code, const char* fragment_code) = 0;
+    virtual int get_shader_location(const Shader& shader, const char* name) = 0;
+    // Enables the shader and sets the uniform, like SetShaderValueV()
+    virtual void set_shader_value(const Shader& shader, int loc, const void* value, int type, int count = 1) = 0;
+    virtual void enable_shader(const Shader& shader) = 0;
+    // These two set a uniform of the enabled shader
+    virtual void set_uniform(int loc, const void* value, int type, int count = 1) = 0;
+    virtual void set_uniform_matrices(int loc, const Matrix* matrices, int count) = 0;
+
+    // Textures, format is a PixelFormat
+    virtual unsigned int load_texture(const void* data, int width, int height, int format) = 0;
+    virtual void update_texture(unsigned int texture, int x, int y, int width, int height, int format, const void* data) = 0;
+    virtual void unload_texture(unsigned int texture) = 0;
+    // Binds the texture to unit and points the enabled shader's sampler at loc to it
+    virtual void bind_texture(int unit, unsigned int texture, int loc) = 0;
+    // Framebuffer with only a depth texture
+    virtual RenderTexture2D load_depth_target(int width, int height) = 0;
+    virtual void unload_render_target(RenderTexture2D& target) = 0;
+
+    // Passes
+    virtual void begin_frame(Color clear) = 0;
+    virtual void end_frame() = 0;
+    virtual void begin_target(const RenderTexture2D& target) = 0;
+    virtual void end_target() = 0;
+    // Only draws inside rect of the target, and clears its depth
+    virtual void begin_viewport(Rectangle rect) = 0;
+    virtual void end_viewport() = 0;
+    // BeginMode3D()
+    virtual void begin_camera(const Camera3D& camera) = 0;
+    virtual void end_camera() = 0;
+    // Same as begin_camera(), with the view and projection given (for the shadow maps)
+    virtual void begin_view(Matrix view, Matrix projection) = 0;
+    virtual void end_view() = 0;
+
+    virtual void draw_mesh(const Mesh& mesh, const Material& material, const Matrix& transform) = 0;
+};
+
+
+#endif //BUSINESS_GAME_RENDERBACKEND_HPP
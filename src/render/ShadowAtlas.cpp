@@ -0,0 +1,94 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/ShadowAtlas.hpp"
+
+#include <raymath.h>
+
+ShadowAtlas::~ShadowAtlas() {
+    unload();
+}
+
+void ShadowAtlas::load(RenderBackend& backend, const int tile_resolution, const int tiles_per_side) {
+    unload();
+    this->backend = &backend;
+
+    this->tile_resolution = tile_resolution;
+    this->tiles_per_side = tiles_per_side;
+    if (get_capacity() > MAX_SHADOW_SLOTS) {
+        TraceLog(LOG_WARNING, "[ShadowAtlas] %i slots requested, the shader only supports %i",
+            get_capacity(), MAX_SHADOW_SLOTS);
+        this->tiles_per_side = 1;
+        while ((this->tiles_per_side + 1) * (this->tiles_per_side + 1) <= MAX_SHADOW_SLOTS) {
+            this->tiles_per_side++;
+        }
+    }
+    used_slots = std::vector<bool>(get_capacity(), false);
+    slot_view_proj = std::vector<Matrix>(get_capacity(), MatrixIdentity());
+
+    const int size = this->tile_resolution * this->tiles_per_side;
+    target = backend.load_depth_target(size, size);
+    if (target.id != 0) {
+        TraceLog(LOG_INFO, "[ShadowAtlas] %ix%i, %i slots", size, size, get_capacity());
+    }
+}
+
+void ShadowAtlas::unload() {
+    if (backend != nullptr) backend->unload_render_target(target);
+    target = {};
+    used_slots.clear();
+    slot_view_proj.clear();
+}
+
+int ShadowAtlas::allocate_slot() {
+    for (int i = 0; i < static_cast<int>(used_slots.size()); i++) {
+        if (!used_slots[i]) {
+            used_slots[i] = true;
+            return i;
+        }
+    }
+    TraceLog(LOG_WARNING, "[ShadowAtlas] no free slot, light will not cast shadows");
+    return -1;
+}
+
+void ShadowAtlas::free_slot(const int slot) {
+    if (slot < 0 || slot >= static_cast<int>(used_slots.size())) return;
+    used_slots[slot] = false;
+    slot_view_proj[slot] = MatrixIdentity();
+}
+
+Rectangle ShadowAtlas::get_slot_viewport(const int slot) const {
+    return Rectangle{
+        static_cast<float>((slot % tiles_per_side) * tile_resolution),
+        static_cast<float>((slot / tiles_per_side) * tile_resolution),
+        static_cast<float>(tile_resolution),
+        static_cast<float>(tile_resolution),
+    };
+}
+
+int ShadowAtlas::get_capacity() const {
+    return tiles_per_side * tiles_per_side;
+}
+
+int ShadowAtlas::get_tiles_per_side() const {
+    return tiles_per_side;
+}
+
+int ShadowAtlas::get_tile_resolution() const {
+    return tile_resolution;
+}
+
+size_t ShadowAtlas::get_gpu_bytes() const {
+    if (target.depth.id == 0) return 0;
+    // 24 bit depth, drivers keep it in 32
+    return static_cast<size_t>(target.depth.width) * target.depth.height * 4;
+}
+
+void ShadowAtlas::begin_slot(const int slot) const {
+    backend->begin_viewport(get_slot_viewport(slot));
+}
+
+void ShadowAtlas::end_slot() const {
+    backend->end_viewport();
+}
@@ -0,0 +1,58 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_SHADOWATLAS_HPP
+#define BUSINESS_GAME_SHADOWATLAS_HPP
+#include <raylib.h>
+#include <vector>
+#include "render/RenderBackend.hpp"
+
+// Must match MAX_SHADOW_SLOTS in lighting.fs
+#define MAX_SHADOW_SLOTS 16
+
+// One depth texture split into a grid of square tiles (slots).
+// Every shadow casting light owns one slot, so adding a light only needs
+// a free slot instead of a new sampler in the shader.
+class ShadowAtlas {
+public:
+    RenderTexture2D target{};
+    // light view-projection matrix of each slot, uploaded in one call
+    std::vector<Matrix> slot_view_proj;
+
+    ShadowAtlas() = default;
+    ~ShadowAtlas();
+
+    ShadowAtlas(const ShadowAtlas&) = delete;
+    ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+
+    // Creates the depth texture, tile_resolution * tiles_per_side pixels wide.
+    void load(RenderBackend& backend, int tile_resolution, int tiles_per_side);
+    void unload();
+
+    // Returns -1 if the atlas is full
+    int allocate_slot();
+    void free_slot(int slot);
+
+    // Pixel rectangle of the slot inside the atlas
+    Rectangle get_slot_viewport(int slot) const;
+    int get_capacity() const;
+    int get_tiles_per_side() const;
+    int get_tile_resolution() const;
+    // Of the depth texture, 0 if it isn't loaded
+    size_t get_gpu_bytes() const;
+
+    // Should always be within a backend.begin_target(target)/end_target() block.
+    // Restricts drawing to the slot and clears its depth.
+    void begin_slot(int slot) const;
+    void end_slot() const;
+
+private:
+    RenderBackend* backend = nullptr;
+    int tile_resolution = 0;
+    int tiles_per_side = 0;
+    std::vector<bool> used_slots;
+};
+
+
+#endif //BUSINESS_GAME_SHADOWATLAS_HPP
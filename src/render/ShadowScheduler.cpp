@@ -0,0 +1,77 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/ShadowScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <raymath.h>
+
+const std::vector<int>& ShadowScheduler::schedule(const std::vector<Light>& lights, const Vector3 camera_position,
+    const unsigned int scene_revision, const std::vector<BoundingBox>& moved) {
+    frame++;
+    stats = {};
+    scheduled.clear();
+    candidates.clear();
+    if (states.size() < lights.size()) states.resize(lights.size());
+
+    for (int i = 0; i < static_cast<int>(lights.size()); i++) {
+        const Light& light = lights[i];
+        LightState& state = states[i];
+        if (light.shadow_slot < 0) continue;
+        if (!light.enabled) {
+            // the tile is not sampled while the light is off, render it again when it comes back
+            state.rendered = false;
+            continue;
+        }
+
+        const Matrix view_proj = MatrixMultiply(light.shadow_view, light.shadow_proj);
+        // stays set until the map is rendered, it may not get its turn this frame
+        if (state.rendered && !state.moved && !moved.empty()) {
+            const Frustum frustum = Frustum::from_matrix(view_proj);
+            state.moved = std::any_of(moved.begin(), moved.end(),
+                [&](const BoundingBox& box) { return frustum.contains(box); });
+        }
+        const bool dirty = !state.rendered
+            || state.moved
+            || state.scene_revision != scene_revision
+            || std::memcmp(&state.view_proj, &view_proj, sizeof(Matrix)) != 0;
+        if (!dirty) continue;
+        stats.dirty++;
+
+        const float staleness = static_cast<float>(frame - state.last_frame);
+        const float distance = Vector3Distance(camera_position, light.position);
+        // never rendered before goes first
+        const float score = state.rendered
+            ? light.shadow_importance * staleness / (1.0f + distance)
+            : INFINITY;
+        candidates.emplace_back(score, i);
+    }
+
+    const int count = std::min(static_cast<int>(candidates.size()), std::max(max_updates_per_frame, 0));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (int c = 0; c < count; c++) {
+        const int i = candidates[c].second;
+        LightState& state = states[i];
+        state.rendered = true;
+        state.view_proj = MatrixMultiply(lights[i].shadow_view, lights[i].shadow_proj);
+        state.scene_revision = scene_revision;
+        state.moved = false;
+        state.last_frame = frame;
+        scheduled.emplace_back(i);
+    }
+    stats.rendered = count;
+    return scheduled;
+}
+
+void ShadowScheduler::invalidate() {
+    for (LightState& state : states) state.rendered = false;
+}
+
+ShadowScheduleStats ShadowScheduler::get_stats() const {
+    return stats;
+}
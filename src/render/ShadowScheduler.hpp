@@ -0,0 +1,56 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_SHADOWSCHEDULER_HPP
+#define BUSINESS_GAME_SHADOWSCHEDULER_HPP
+#include <raylib.h>
+#include <vector>
+#include "render/LightManager.hpp"
+
+struct ShadowScheduleStats {
+    int dirty = 0;     // shadow maps that are out of date
+    int rendered = 0;  // shadow maps rendered this frame
+};
+
+// Spreads the shadow passes over several frames.
+// A shadow map only needs to be rendered again when its light's frustum changed,
+// the light was turned back on, the scene changed, or something that moved this frame
+// (where it was or where it is now) is inside its frustum. Out of those, at most
+// max_updates_per_frame are picked each frame, scored by
+//   importance * frames since the last update / (1 + distance to the camera)
+// so lights that are skipped climb up the list until they are rendered.
+// The rest keep their old tile and old lightVP, which still match each other.
+class ShadowScheduler {
+public:
+    int max_updates_per_frame = 1;
+
+    // Returns the indices (into lights) of the shadow maps to render this frame.
+    // Those are assumed to be rendered, with the light's current shadow_view/shadow_proj.
+    // moved: world bounds of the casters that moved since last frame, before and after.
+    const std::vector<int>& schedule(const std::vector<Light>& lights, Vector3 camera_position,
+        unsigned int scene_revision, const std::vector<BoundingBox>& moved);
+
+    // Forces every shadow map to be rendered again
+    void invalidate();
+
+    ShadowScheduleStats get_stats() const;
+
+private:
+    struct LightState {
+        bool rendered = false;
+        Matrix view_proj{};
+        unsigned int scene_revision = 0;
+        bool moved = false; // something moved inside the frustum since it was rendered
+        unsigned long long last_frame = 0;
+    };
+
+    std::vector<LightState> states;
+    std::vector<int> scheduled;
+    std::vector<std::pair<float, int>> candidates;
+    unsigned long long frame = 0;
+    ShadowScheduleStats stats;
+};
+
+
+#endif //BUSINESS_GAME_SHADOWSCHEDULER_HPP
@@ -0,0 +1,301 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "render/SpatialIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <raymath.h>
+#include "voxel/VoxelGrid.hpp"
+
+static float getSurfaceArea(const BoundingBox& box) {
+    const Vector3 d = Vector3Subtract(box.max, box.min);
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+static bool boxContains(const BoundingBox& outer, const BoundingBox& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+        && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+static bool boxesOverlap(const BoundingBox& a, const BoundingBox& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x
+        && a.min.y <= b.max.y && b.min.y <= a.max.y
+        && a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+void SpatialIndex::update(ModelInfo* model, VoxelGrid* grid) {
+    const BoundingBox& bounds = model->world_bounds;
+    int leaf;
+    if (const auto it = leaves.find(model); it != leaves.end()) {
+        leaf = it->second;
+        nodes[leaf].item.grid = grid;
+        if (boxContains(nodes[leaf].box, bounds)) return;
+        remove_leaf(leaf);
+        reinserts++;
+    } else {
+        leaf = allocate_node();
+        nodes[leaf].item = SpatialItem{model, grid};
+        leaves[model] = leaf;
+    }
+
+    const Vector3 margin = {SPATIAL_INDEX_MARGIN, SPATIAL_INDEX_MARGIN, SPATIAL_INDEX_MARGIN};
+    nodes[leaf].box = BoundingBox{Vector3Subtract(bounds.min, margin), Vector3Add(bounds.max, margin)};
+    insert_leaf(leaf);
+}
+
+void SpatialIndex::remove(const ModelInfo* model) {
+    const auto it = leaves.find(model);
+    if (it == leaves.end()) return;
+    remove_leaf(it->second);
+    free_node(it->second);
+    leaves.erase(it);
+}
+
+int SpatialIndex::allocate_node() {
+    if (free_nodes.empty()) {
+        nodes.emplace_back();
+        return static_cast<int>(nodes.size()) - 1;
+    }
+    const int node = free_nodes.back();
+    free_nodes.pop_back();
+    nodes[node] = Node{};
+    return node;
+}
+
+void SpatialIndex::free_node(const int node) {
+    free_nodes.emplace_back(node);
+}
+
+void SpatialIndex::insert_leaf(const int leaf) {
+    nodes[leaf].parent = -1;
+    nodes[leaf].children[0] = nodes[leaf].children[1] = -1;
+    nodes[leaf].height = 0;
+    if (root < 0) {
+        root = leaf;
+        return;
+    }
+
+    // Find the sibling: going down costs the area the parents grow by, stop
+    // once putting the leaf next to the current node is cheaper than going further
+    const BoundingBox box = nodes[leaf].box;
+    int sibling = root;
+    while (!nodes[sibling].is_leaf()) {
+        const Node& node = nodes[sibling];
+        const float area = getSurfaceArea(node.box);
+        const float combined = getSurfaceArea(mergeBoundingBox(node.box, box));
+        const float cost_here = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+
+        float costs[2];
+        for (int i = 0; i < 2; i++) {
+            const Node& child = nodes[node.children[i]];
+            const float merged = getSurfaceArea(mergeBoundingBox(child.box, box));
+            costs[i] = (child.is_leaf() ? merged : merged - getSurfaceArea(child.box)) + inherited;
+        }
+        if (cost_here < costs[0] && cost_here < costs[1]) break;
+        sibling = node.children[costs[0] < costs[1] ? 0 : 1];
+    }
+
+    // New parent in place of the sibling
+    const int old_parent = nodes[sibling].parent;
+    const int parent = allocate_node();
+    nodes[parent].parent = old_parent;
+    nodes[parent].box = mergeBoundingBox(nodes[sibling].box, box);
+    nodes[parent].height = nodes[sibling].height + 1;
+    nodes[parent].children[0] = sibling;
+    nodes[parent].children[1] = leaf;
+    nodes[sibling].parent = parent;
+    nodes[leaf].parent = parent;
+    if (old_parent < 0) {
+        root = parent;
+    } else {
+        Node& above = nodes[old_parent];
+        above.children[above.children[0] == sibling ? 0 : 1] = parent;
+    }
+
+    fix_upwards(nodes[leaf].parent);
+}
+
+void SpatialIndex::remove_leaf(const int leaf) {
+    if (leaf == root) {
+        root = -1;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    const int parent = nodes[leaf].parent;
+    const int grandparent = nodes[parent].parent;
+    const int sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+    free_node(parent);
+    nodes[sibling].parent = grandparent;
+    nodes[leaf].parent = -1;
+    if (grandparent < 0) {
+        root = sibling;
+        return;
+    }
+    Node& above = nodes[grandparent];
+    above.children[above.children[0] == parent ? 0 : 1] = sibling;
+    fix_upwards(grandparent);
+}
+
+void SpatialIndex::fix_upwards(int node) {
+    while (node >= 0) {
+        node = balance(node);
+        Node& n = nodes[node];
+        const Node& a = nodes[n.children[0]];
+        const Node& b = nodes[n.children[1]];
+        n.height = 1 + std::max(a.height, b.height);
+        n.box = mergeBoundingBox(a.box, b.box);
+        node = n.parent;
+    }
+}
+
+int SpatialIndex::balance(const int a) {
+    // a has children b and c, c has f and g.
+    // If c is taller than b by 2 or more, c moves up into a's place and
+    // a takes over the shorter of c's children. Same the other way around.
+    if (nodes[a].is_leaf() || nodes[a].height < 2) return a;
+
+    for (int side = 0; side < 2; side++) {
+        const int b = nodes[a].children[side];
+        const int c = nodes[a].children[1 - side];
+        if (nodes[c].height - nodes[b].height < 2) continue;
+
+        const int f = nodes[c].children[0];
+        const int g = nodes[c].children[1];
+
+        // c goes up
+        nodes[c].children[0] = a;
+        nodes[c].parent = nodes[a].parent;
+        nodes[a].parent = c;
+        if (nodes[c].parent < 0) {
+            root = c;
+        } else {
+            Node& above = nodes[nodes[c].parent];
+            above.children[above.children[0] == a ? 0 : 1] = c;
+        }
+
+        // the taller of f and g stays with c, the other one goes to a
+        const int keep = nodes[f].height > nodes[g].height ? f : g;
+        const int give = keep == f ? g : f;
+        nodes[c].children[1] = keep;
+        nodes[a].children[1 - side] = give;
+        nodes[give].parent = a;
+
+        nodes[a].box = mergeBoundingBox(nodes[b].box, nodes[give].box);
+        nodes[a].height = 1 + std::max(nodes[b].height, nodes[give].height);
+        nodes[c].box = mergeBoundingBox(nodes[a].box, nodes[keep].box);
+        nodes[c].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+        return c;
+    }
+    return a;
+}
+
+template<class Overlaps>
+void SpatialIndex::query(const Overlaps& overlaps, std::vector<SpatialItem>& out) const {
+    out.clear();
+    if (root < 0) return;
+    stack.clear();
+    stack.emplace_back(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (node.is_leaf()) {
+            // the leaf's box has the margin, the model's own bounds decide
+            if (overlaps(node.item.model->world_bounds)) out.emplace_back(node.item);
+            continue;
+        }
+        if (!overlaps(node.box)) continue;
+        stack.emplace_back(node.children[0]);
+        stack.emplace_back(node.children[1]);
+    }
+}
+
+void SpatialIndex::query_frustum(const Frustum& frustum, std::vector<SpatialItem>& out) const {
+    out.clear();
+    if (root < 0) return;
+    stack.clear();
+    stack.emplace_back(root);
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        if (node.is_leaf()) {
+            if (frustum.contains(node.item.model->world_bounds)) out.emplace_back(node.item);
+            continue;
+        }
+        if (!frustum.contains(node.box)) continue;
+        // everything under a node that is all inside is visible, no need to test it
+        if (frustum.encloses(node.box)) {
+            collect_leaves(index, out);
+            continue;
+        }
+        stack.emplace_back(node.children[0]);
+        stack.emplace_back(node.children[1]);
+    }
+}
+
+void SpatialIndex::collect_leaves(const int node, std::vector<SpatialItem>& out) const {
+    if (nodes[node].is_leaf()) {
+        out.emplace_back(nodes[node].item);
+        return;
+    }
+    collect_leaves(nodes[node].children[0], out);
+    collect_leaves(nodes[node].children[1], out);
+}
+
+void SpatialIndex::query_box(const BoundingBox& box, std::vector<SpatialItem>& out) const {
+    query([&](const BoundingBox& other) { return boxesOverlap(box, other); }, out);
+}
+
+void SpatialIndex::query_radius(const Vector3 centre, const float radius, std::vector<SpatialItem>& out) const {
+    const float radius_sqr = radius * radius;
+    query([&](const BoundingBox& box) {
+        // squared distance from centre to the closest point of the box
+        const float dx = fmaxf(fmaxf(box.min.x - centre.x, 0.0f), centre.x - box.max.x);
+        const float dy = fmaxf(fmaxf(box.min.y - centre.y, 0.0f), centre.y - box.max.y);
+        const float dz = fmaxf(fmaxf(box.min.z - centre.z, 0.0f), centre.z - box.max.z);
+        return dx * dx + dy * dy + dz * dz <= radius_sqr;
+    }, out);
+}
+
+void SpatialIndex::query_ray(const Ray& ray, const float max_distance, std::vector<SpatialItem>& out) const {
+    const float origin[3] = {ray.position.x, ray.position.y, ray.position.z};
+    const float direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+    float inverse[3];
+    for (int i = 0; i < 3; i++) inverse[i] = direction[i] != 0.0f ? 1.0f / direction[i] : INFINITY;
+
+    query([&](const BoundingBox& box) {
+        // slab test, t has to stay in [0, max_distance] on every axis
+        const float lo[3] = {box.min.x, box.min.y, box.min.z};
+        const float hi[3] = {box.max.x, box.max.y, box.max.z};
+        float t_enter = 0.0f, t_exit = max_distance;
+        for (int i = 0; i < 3; i++) {
+            if (direction[i] == 0.0f) {
+                if (origin[i] < lo[i] || origin[i] > hi[i]) return false;
+                continue;
+            }
+            float t0 = (lo[i] - origin[i]) * inverse[i];
+            float t1 = (hi[i] - origin[i]) * inverse[i];
+            if (t0 > t1) std::swap(t0, t1);
+            t_enter = std::max(t_enter, t0);
+            t_exit = std::min(t_exit, t1);
+            if (t_enter > t_exit) return false;
+        }
+        return true;
+    }, out);
+}
+
+BoundingBox SpatialIndex::get_bounds() const {
+    return root >= 0 ? nodes[root].box : BoundingBox{};
+}
+
+SpatialIndexStats SpatialIndex::get_stats() const {
+    SpatialIndexStats stats;
+    stats.items = static_cast<int>(leaves.size());
+    stats.height = root >= 0 ? nodes[root].height : 0;
+    stats.reinserts = reinserts;
+    return stats;
+}
@@ -0,0 +1,88 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_SPATIALINDEX_HPP
+#define BUSINESS_GAME_SPATIALINDEX_HPP
+#include <raylib.h>
+#include <unordered_map>
+#include <vector>
+#include "render/Frustum.hpp"
+
+#define SPATIAL_INDEX_MARGIN 0.2f // leaves are this much bigger than their model, so small moves don't reinsert them
+
+struct ModelInfo;
+class VoxelGrid;
+
+struct SpatialItem {
+    ModelInfo* model;
+    VoxelGrid* grid; // the model's
+};
+
+struct SpatialIndexStats {
+    int items = 0;
+    int height = 0;     // of the tree, 0 if it only has one item
+    int reinserts = 0;  // update()s that had to move the item in the tree
+};
+
+// Dynamic bounding volume hierarchy over the world bounds of models (ModelInfo::world_bounds).
+// Every item is a leaf with a slightly bigger box, the inner nodes are the boxes around their
+// two children. Inserting goes down to the sibling that grows the tree's surface area the least,
+// then the path back up is rebalanced with rotations, so queries stay O(log n + found).
+// The grids keep their models in here (see VoxelGrid::spatial_index), they are found by address.
+class SpatialIndex {
+public:
+    // Adds the model, or moves it if its world_bounds left its leaf
+    void update(ModelInfo* model, VoxelGrid* grid);
+    void remove(const ModelInfo* model);
+    bool contains(const ModelInfo* model) const { return leaves.contains(model); }
+    size_t size() const { return leaves.size(); }
+
+    // The queries clear out first, the items come in no particular order
+    void query_frustum(const Frustum& frustum, std::vector<SpatialItem>& out) const;
+    void query_box(const BoundingBox& box, std::vector<SpatialItem>& out) const;
+    // Items whose bounds are closer than radius to centre
+    void query_radius(Vector3 centre, float radius, std::vector<SpatialItem>& out) const;
+    // Items whose bounds the ray goes through before max_distance (in units of the ray's direction)
+    void query_ray(const Ray& ray, float max_distance, std::vector<SpatialItem>& out) const;
+
+    // Box around every item, empty box if there are none
+    BoundingBox get_bounds() const;
+    SpatialIndexStats get_stats() const;
+
+private:
+    struct Node {
+        BoundingBox box{};
+        int parent = -1;
+        int children[2] = {-1, -1}; // both -1 for leaves
+        int height = 0;             // 0 for leaves
+        SpatialItem item{};
+
+        bool is_leaf() const { return children[0] < 0; }
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    int root = -1;
+    std::unordered_map<const ModelInfo*, int> leaves;
+    int reinserts = 0;
+    mutable std::vector<int> stack;
+
+    int allocate_node();
+    void free_node(int node);
+    void insert_leaf(int leaf);
+    void remove_leaf(int leaf);
+    // Rotates the subtree at node if one side is more than one level taller, returns its new root
+    int balance(int node);
+    // Refits the boxes and heights from node up to the root, balancing on the way
+    void fix_upwards(int node);
+    // Every item under node, without testing them
+    void collect_leaves(int node, std::vector<SpatialItem>& out) const;
+
+    // Every item whose box passes overlaps (a function of const BoundingBox&)
+    template<class Overlaps>
+    void query(const Overlaps& overlaps, std::vector<SpatialItem>& out) const;
+};
+
+
+#endif //BUSINESS_GAME_SPATIALINDEX_HPP
@@ -0,0 +1,88 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "sim/JobPool.hpp"
+
+#include <algorithm>
+
+JobPool::JobPool(int workers) {
+    if (workers < 0) {
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workers = std::max(cores + workers, 0);
+    }
+    for (int i = 0; i < workers; i++) {
+        this->workers.emplace_back(&JobPool::worker_loop, this);
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void JobPool::parallel_for(const size_t count, const size_t batch_size,
+    const std::function<void(size_t begin, size_t end)>& job) {
+    if (count == 0) return;
+    const size_t batch = std::max<size_t>(batch_size, 1);
+    const size_t batches = (count + batch - 1) / batch;
+
+    // Not worth waking anyone up
+    if (workers.empty() || batches == 1) {
+        for (size_t b = 0; b < batches; b++) job(b * batch, std::min(count, (b + 1) * batch));
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        this->job = &job;
+        job_count = count;
+        job_batch_size = batch;
+        job_batches = batches;
+        next_batch = 0;
+        finished_batches = 0;
+        generation++;
+    }
+    wake.notify_all();
+    run_batches();
+
+    // Every batch is done and no worker is still looking at this job
+    std::unique_lock lock(mutex);
+    done.wait(lock, [&] { return finished_batches == job_batches && active == 0; });
+    this->job = nullptr;
+}
+
+void JobPool::worker_loop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (job == nullptr) continue; // woke up after the job was already finished
+            active++;
+        }
+        run_batches();
+        {
+            std::lock_guard lock(mutex);
+            active--;
+        }
+        done.notify_all();
+    }
+}
+
+void JobPool::run_batches() {
+    size_t b;
+    while ((b = next_batch.fetch_add(1)) < job_batches) {
+        (*job)(b * job_batch_size, std::min(job_count, (b + 1) * job_batch_size));
+        if (finished_batches.fetch_add(1) + 1 == job_batches) {
+            std::lock_guard lock(mutex);
+            done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_JOBPOOL_HPP
+#define BUSINESS_GAME_JOBPOOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for data-parallel loops.
+// parallel_for() splits [0, count) into fixed batches and hands them out to the
+// workers and the calling thread, then waits for all of them. Which thread runs
+// a batch changes from call to call, but the batches themselves don't, so a job
+// that only writes inside its own batch gives the same result with any thread count.
+class JobPool {
+public:
+    // workers < 0: one per core, less -workers. With -1 the workers and the calling thread fill every core.
+    explicit JobPool(int workers = -1);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // Calls job(begin, end) for every batch of at most batch_size indices
+    void parallel_for(size_t count, size_t batch_size, const std::function<void(size_t begin, size_t end)>& job);
+
+    // Workers + the calling thread
+    int get_thread_count() const { return static_cast<int>(workers.size()) + 1; }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    uint64_t generation = 0; // bumped for every parallel_for()
+    int active = 0;          // workers inside run_batches()
+
+    // the current job, only changed while no worker is active
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t job_count = 0;
+    size_t job_batch_size = 0;
+    size_t job_batches = 0;
+    std::atomic<size_t> next_batch{0};
+    std::atomic<size_t> finished_batches{0};
+
+    void worker_loop();
+    void run_batches();
+};
+
+
+#endif //BUSINESS_GAME_JOBPOOL_HPP
@@ -0,0 +1,154 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "sim/Simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <raylib.h>
+#include <raymath.h>
+#include "voxel/VoxelMap.hpp"
+
+double getSimClock() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+Simulation::~Simulation() {
+    stop();
+}
+
+void Simulation::set_terrain(const VoxelMap& map) {
+    terrain.load(map);
+}
+
+void Simulation::generate_economy(const int town_count, const int industry_count, const uint32_t seed) {
+    if (!jobs) jobs = std::make_unique<JobPool>(SIM_WORKER_THREADS);
+    economy.generate(Int2{terrain.width, terrain.height}, town_count, industry_count, seed, *jobs);
+}
+
+void Simulation::start() {
+    if (running) return;
+    dt = 1.0 / std::max(tick_rate, 1);
+    if (!jobs) jobs = std::make_unique<JobPool>(SIM_WORKER_THREADS);
+    publish(getSimClock());
+    snapshots.update();
+    previous = current = snapshots.front();
+    running = true;
+    thread = std::thread(&Simulation::run, this);
+    TraceLog(LOG_INFO, "[Simulation] started at %i ticks/s, on %i threads", tick_rate, jobs->get_thread_count());
+}
+
+void Simulation::stop() {
+    if (!running) return;
+    running = false;
+    thread.join();
+}
+
+const SimSnapshot& Simulation::get_frame() {
+    if (snapshots.update()) {
+        previous = current;
+        current = snapshots.front();
+
+        std::fill(previous_index.begin(), previous_index.end(), -1);
+        for (size_t i = 0; i < previous.entity_ids.size(); i++) {
+            const uint32_t slot = previous.entity_ids[i].slot;
+            if (slot >= previous_index.size()) previous_index.resize(slot + 1, -1);
+            previous_index[slot] = static_cast<int>(i);
+        }
+    }
+
+    // How far past the current snapshot we are, in ticks
+    const double ticks = static_cast<double>(std::max<uint64_t>(current.tick - previous.tick, 1));
+    const double alpha = std::clamp((getSimClock() - current.published) / (dt * ticks), 0.0, 1.0);
+    const auto a = static_cast<float>(alpha);
+
+    frame = current;
+    frame.time = previous.time + (current.time - previous.time) * alpha;
+    frame.sun_angle = previous.sun_angle + (current.sun_angle - previous.sun_angle) * a;
+
+    // Entities that were already there last snapshot move from where they were
+    for (size_t i = 0; i < frame.entity_ids.size(); i++) {
+        const EntityId id = frame.entity_ids[i];
+        if (id.slot >= previous_index.size() || previous_index[id.slot] < 0) continue;
+        const int p = previous_index[id.slot];
+        if (!(previous.entity_ids[p] == id)) continue;
+
+        frame.entity_positions[i] = Vector3Lerp(previous.entity_positions[p], current.entity_positions[i], a);
+        const float turn = std::remainder(current.entity_headings[i] - previous.entity_headings[p], 2.0f * PI);
+        frame.entity_headings[i] = previous.entity_headings[p] + turn * a;
+    }
+    return frame;
+}
+
+SimStats Simulation::get_stats() const {
+    return SimStats{tick_ms.load(), ticks_per_second.load(), dropped_ticks.load()};
+}
+
+void Simulation::run() {
+    double next_tick = getSimClock();
+    double second_start = next_tick, busy = 0.0;
+    int ticks_this_second = 0;
+
+    while (running) {
+        // Every tick that is due, but never more than SIM_MAX_CATCH_UP_TICKS.
+        // Woken up early, nothing is due yet (the cast would round up to the next tick)
+        const double now = getSimClock();
+        int due = now < next_tick ? 0 : static_cast<int>(std::floor((now - next_tick) / dt)) + 1;
+        if (due > SIM_MAX_CATCH_UP_TICKS) {
+            dropped_ticks += due - SIM_MAX_CATCH_UP_TICKS;
+            next_tick += (due - SIM_MAX_CATCH_UP_TICKS) * dt;
+            due = SIM_MAX_CATCH_UP_TICKS;
+        }
+        if (due > 0) {
+            for (int i = 0; i < due; i++) {
+                tick();
+                next_tick += dt;
+            }
+            const double finished = getSimClock();
+            busy += finished - now;
+            ticks_this_second += due;
+
+            publish(finished);
+        }
+
+        if (getSimClock() - second_start >= 1.0) {
+            tick_ms = ticks_this_second > 0 ? busy * 1000.0 / ticks_this_second : 0.0;
+            ticks_per_second = ticks_this_second;
+            second_start = getSimClock();
+            busy = 0.0;
+            ticks_this_second = 0;
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(std::max(next_tick - getSimClock(), 0.0)));
+    }
+}
+
+void Simulation::tick() {
+    state.tick++;
+    state.time += dt;
+    if (sun_cycle) {
+        // not wrapped, so interpolating never goes the long way round
+        state.sun_angle += sun_speed * static_cast<float>(dt);
+    }
+    updateVehicles(entities, routes, terrain, static_cast<float>(dt), *jobs);
+    if (state.tick % SIM_TICKS_PER_DAY == 0) economy.tick(*jobs);
+}
+
+void Simulation::publish(const double now) {
+    state.published = now;
+    SimSnapshot& snapshot = snapshots.back();
+    // the vectors keep their capacity, so after the first few this doesn't allocate
+    snapshot.tick = state.tick;
+    snapshot.time = state.time;
+    snapshot.published = state.published;
+    snapshot.sun_angle = state.sun_angle;
+    snapshot.entity_ids = entities.ids;
+    snapshot.entity_positions = entities.positions;
+    snapshot.entity_headings = entities.headings;
+    snapshot.entity_models = entities.models;
+    snapshot.economy = economy.get_stats();
+    snapshots.publish();
+}
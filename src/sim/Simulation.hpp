@@ -0,0 +1,114 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_SIMULATION_HPP
+#define BUSINESS_GAME_SIMULATION_HPP
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "sim/TripleBuffer.hpp"
+#include "entity/EntityStore.hpp"
+#include "sim/JobPool.hpp"
+#include "sim/VehicleSystem.hpp"
+#include "economy/Economy.hpp"
+
+class VoxelMap;
+
+#define SIM_TICK_RATE 30        // ticks per second
+#define SIM_MAX_CATCH_UP_TICKS 5 // after a stall, ticks that are further behind than this are dropped
+#define SIM_WORKER_THREADS -2    // see JobPool(), leaves a core for the render thread
+#define SIM_TICKS_PER_DAY 30     // the economy moves on a day every second
+
+// Everything the renderer needs from one simulation tick
+struct SimSnapshot {
+    uint64_t tick = 0;
+    double time = 0.0;      // simulated seconds
+    double published = 0.0; // wall clock (steady, seconds) when it was published
+    float sun_angle = 0.0f; // radians around the sun's target
+
+    // Entities to draw, same layout as EntityStore
+    std::vector<EntityId> entity_ids;
+    std::vector<Vector3> entity_positions;
+    std::vector<float> entity_headings;
+    std::vector<int> entity_models;
+
+    EconomyStats economy;
+};
+
+struct SimStats {
+    double tick_ms = 0.0;  // average time spent in tick(), over the last second
+    int ticks_per_second = 0;
+    uint64_t dropped_ticks = 0;
+};
+
+// Fixed-timestep simulation, on its own thread.
+// The simulation thread owns the state and runs tick() tick_rate times a second,
+// catching up if it fell behind. After every batch of ticks it publishes a
+// snapshot through a triple buffer, so neither thread ever waits for the other.
+// The render thread calls get_frame(), which interpolates between the last two
+// snapshots it has seen: the picture is one tick behind, but moves smoothly
+// whatever the frame rate is.
+class Simulation {
+public:
+    int tick_rate = SIM_TICK_RATE; // only read by start()
+    // Owned by the simulation thread once it is started
+    EntityStore entities;
+    RouteTable routes;
+    Economy economy;
+
+    // Commands from the render thread
+    std::atomic<bool> sun_cycle{false};
+    std::atomic<float> sun_speed{0.05f}; // radians per simulated second
+
+    Simulation() = default;
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // Copies the surface of the map, vehicles drive on it. Call before start().
+    void set_terrain(const VoxelMap& map);
+    // Scatters towns and industries over the terrain. Call after set_terrain(), before start().
+    void generate_economy(int town_count, int industry_count, uint32_t seed);
+
+    void start();
+    void stop();
+
+    // Render thread only: the state at this moment, interpolated.
+    // Stays valid until the next call.
+    const SimSnapshot& get_frame();
+    SimStats get_stats() const;
+
+private:
+    std::thread thread;
+    std::atomic<bool> running{false};
+    double dt = 1.0 / SIM_TICK_RATE;
+
+    // simulation thread only
+    SimSnapshot state;
+    Heightmap terrain;
+    std::unique_ptr<JobPool> jobs; // created by start()
+    void run();
+    void tick();
+    void publish(double now);
+
+    TripleBuffer<SimSnapshot> snapshots;
+
+    // render thread only
+    SimSnapshot previous;
+    SimSnapshot current;
+    SimSnapshot frame;
+    std::vector<int> previous_index; // per entity slot, its index in previous
+
+    std::atomic<double> tick_ms{0.0};
+    std::atomic<int> ticks_per_second{0};
+    std::atomic<uint64_t> dropped_ticks{0};
+};
+
+// Wall clock used by the simulation, in seconds
+double getSimClock();
+
+#endif //BUSINESS_GAME_SIMULATION_HPP
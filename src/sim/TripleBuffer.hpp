@@ -0,0 +1,41 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_TRIPLEBUFFER_HPP
+#define BUSINESS_GAME_TRIPLEBUFFER_HPP
+#include <array>
+#include <atomic>
+
+// Lock-free hand-off of values from one writer thread to one reader thread.
+// The writer fills back() and publish()es it, the reader calls update() and reads front().
+// Neither side ever waits for the other: the third slot sits in the middle holding
+// the newest published value until the reader takes it (or the writer replaces it).
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer only
+    T& back() { return slots[back_index]; }
+    void publish() {
+        back_index = middle.exchange(back_index | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader only. Returns true if front() changed, i.e. something was published since the last call
+    bool update() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        front_index = middle.exchange(front_index, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots[front_index]; }
+
+private:
+    static constexpr int INDEX = 3; // low bits of middle: the slot
+    static constexpr int FRESH = 4; // set when the middle slot has not been read yet
+
+    std::array<T, 3> slots{};
+    int back_index = 0;
+    int front_index = 1;
+    std::atomic<int> middle{2};
+};
+
+#endif //BUSINESS_GAME_TRIPLEBUFFER_HPP
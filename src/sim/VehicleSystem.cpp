@@ -0,0 +1,116 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "sim/VehicleSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "voxel/VoxelMap.hpp"
+
+void Heightmap::load(const VoxelMap& map) {
+    const Int2 chunks = map.get_chunk_count();
+    width = chunks.x * CHUNK_SIZE;
+    height = chunks.y * CHUNK_SIZE;
+    heights.assign(width * height, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            heights[x + y * width] = static_cast<uint8_t>(map.get_surface_height({x, y}));
+        }
+    }
+}
+
+int RouteTable::add(const std::vector<Int2>& tiles) {
+    if (tiles.size() < 2) return -1;
+
+    Route route;
+    for (const Int2& tile : tiles) {
+        route.points.emplace_back(Vector2{static_cast<float>(tile.x) + 0.5f, static_cast<float>(tile.y) + 0.5f});
+    }
+    // and back, without repeating the two ends
+    for (size_t i = tiles.size() - 2; i > 0; i--) route.points.emplace_back(route.points[i]);
+
+    const size_t n = route.points.size();
+    for (size_t i = 0; i < n; i++) {
+        const Vector2 a = route.points[i], b = route.points[(i + 1) % n];
+        route.lengths.emplace_back(std::hypot(b.x - a.x, b.y - a.y));
+        route.headings.emplace_back(std::atan2(b.y - a.y, b.x - a.x));
+    }
+    routes.emplace_back(std::move(route));
+    return static_cast<int>(routes.size()) - 1;
+}
+
+// Straight line movement, no branches so the compiler can vectorise it
+static void integrateBatch(Vector3* positions, const Vector2* velocities, const int* routes,
+    const size_t count, const float dt) {
+    for (size_t i = 0; i < count; i++) {
+        const float free = routes[i] < 0 ? 1.0f : 0.0f;
+        positions[i].x += velocities[i].x * dt * free;
+        positions[i].y += velocities[i].y * dt * free;
+    }
+}
+
+static void followRoute(const Route& route, Vector3& position, float& heading, uint32_t& segment, float& offset,
+    const float distance) {
+    const size_t n = route.points.size();
+    float remaining = distance;
+    while (remaining > 0.0f) {
+        const float left = route.lengths[segment] - offset;
+        if (remaining < left) {
+            offset += remaining;
+            break;
+        }
+        remaining -= left;
+        segment = (segment + 1) % n;
+        offset = 0.0f;
+    }
+
+    const Vector2 a = route.points[segment], b = route.points[(segment + 1) % n];
+    const float t = route.lengths[segment] > 0.0f ? offset / route.lengths[segment] : 0.0f;
+    position.x = a.x + (b.x - a.x) * t;
+    position.y = a.y + (b.y - a.y) * t;
+    heading = route.headings[segment];
+}
+
+void updateVehicles(EntityStore& entities, const RouteTable& routes, const Heightmap& terrain, const float dt,
+    JobPool& pool) {
+    Vector3* positions = entities.positions.data();
+    Vector2* velocities = entities.velocities.data();
+    float* headings = entities.headings.data();
+    const EntityKind* kinds = entities.kinds.data();
+    const int* route_ids = entities.routes.data();
+    uint32_t* segments = entities.route_segments.data();
+    float* offsets = entities.route_offsets.data();
+    const float* speeds = entities.speeds.data();
+    const float width = static_cast<float>(terrain.width), height = static_cast<float>(terrain.height);
+
+    pool.parallel_for(entities.size(), VEHICLE_BATCH_SIZE, [&](const size_t begin, const size_t end) {
+        integrateBatch(positions + begin, velocities + begin, route_ids + begin, end - begin, dt);
+
+        for (size_t i = begin; i < end; i++) {
+            if (kinds[i] != VEHICLE_ENTITY) continue;
+            Vector3& p = positions[i];
+
+            if (route_ids[i] >= 0) {
+                const Route& route = routes.routes[route_ids[i]];
+                if (route.points.size() >= 2) followRoute(route, p, headings[i], segments[i], offsets[i], speeds[i] * dt);
+            } else if (!terrain.empty()) {
+                // bounce off the edges of the map
+                Vector2& v = velocities[i];
+                if (p.x < 0.0f || p.x >= width) {
+                    v.x = -v.x;
+                    p.x = std::clamp(p.x, 0.0f, width - 0.001f);
+                    headings[i] = std::atan2(v.y, v.x);
+                }
+                if (p.y < 0.0f || p.y >= height) {
+                    v.y = -v.y;
+                    p.y = std::clamp(p.y, 0.0f, height - 0.001f);
+                    headings[i] = std::atan2(v.y, v.x);
+                }
+            }
+
+            // on top of the ground
+            if (!terrain.empty()) p.z = terrain.get(p.x, p.y);
+        }
+    });
+}
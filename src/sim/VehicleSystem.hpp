@@ -0,0 +1,54 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_VEHICLESYSTEM_HPP
+#define BUSINESS_GAME_VEHICLESYSTEM_HPP
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+#include "entity/EntityStore.hpp"
+#include "sim/JobPool.hpp"
+#include "voxel/VoxelGrid.hpp"
+
+class VoxelMap;
+
+#define VEHICLE_BATCH_SIZE 2048 // vehicles per job
+
+// Copy of the surface of a VoxelMap, so the simulation can read it while the map changes
+struct Heightmap {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> heights; // highest solid voxel + 1 of every column
+
+    void load(const VoxelMap& map);
+    bool empty() const { return heights.empty(); }
+    float get(const float x, const float y) const {
+        return heights[static_cast<int>(x) + static_cast<int>(y) * width];
+    }
+};
+
+// Tracks vehicles can follow. Every route is a closed loop of points in map space.
+struct Route {
+    std::vector<Vector2> points;
+    std::vector<float> lengths;  // of segment i, from points[i] to points[i + 1] (wrapping)
+    std::vector<float> headings; // of segment i
+};
+
+struct RouteTable {
+    std::vector<Route> routes;
+
+    // A route there (through the centres of the tiles) and back again. Returns its index, -1 if too short.
+    int add(const std::vector<Int2>& tiles);
+};
+
+// One tick of every vehicle.
+// Vehicles with a route drive along it at their speed, the others drive straight
+// with their velocity and bounce off the edges of the map. Both stand on the terrain.
+// Vehicles are updated in batches of VEHICLE_BATCH_SIZE across the pool; a vehicle
+// only reads shared data and writes its own components, so the result is the same
+// with any number of threads.
+void updateVehicles(EntityStore& entities, const RouteTable& routes, const Heightmap& terrain, float dt,
+    JobPool& pool);
+
+#endif //BUSINESS_GAME_VEHICLESYSTEM_HPP
@@ -0,0 +1,72 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "voxel/ChunkStreamer.hpp"
+
+#include <algorithm>
+#include "voxel/VoxelMap.hpp"
+
+ChunkStreamer::ChunkStreamer(const int workers) {
+    for (int i = 0; i < std::max(workers, 1); i++) {
+        this->workers.emplace_back(&ChunkStreamer::worker_loop, this);
+    }
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+
+    for (StreamedChunk& chunk : finished) unload_chunk_mesh(chunk.meshes);
+}
+
+void ChunkStreamer::request(const Int2 chunk_pos, const VoxelChunk* saved) {
+    {
+        std::lock_guard lock(mutex);
+        queue.emplace_back(Request{chunk_pos, saved ? std::optional(*saved) : std::nullopt});
+    }
+    wake.notify_one();
+}
+
+bool ChunkStreamer::cancel(const Int2 chunk_pos) {
+    std::lock_guard lock(mutex);
+    const auto it = std::find_if(queue.begin(), queue.end(), [&](const Request& r) { return r.chunk_pos == chunk_pos; });
+    if (it == queue.end()) return false;
+    queue.erase(it);
+    return true;
+}
+
+void ChunkStreamer::collect(std::vector<StreamedChunk>& out, const size_t max) {
+    std::lock_guard lock(mutex);
+    const size_t count = std::min(max, finished.size());
+    for (size_t i = 0; i < count; i++) out.emplace_back(std::move(finished[i]));
+    finished.erase(finished.begin(), finished.begin() + static_cast<long>(count));
+}
+
+void ChunkStreamer::worker_loop() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        StreamedChunk chunk;
+        chunk.chunk_pos = request.chunk_pos;
+        if (request.saved.has_value()) chunk.voxels = *request.saved;
+        else VoxelMap::generate_chunk(chunk.voxels, request.chunk_pos);
+        chunk.summary.rebuild(chunk.voxels);
+        chunk.meshes = build_chunk_mesh_data(chunk.voxels, Vector3{0.0, 0.0, 0.0}, 1.0f, chunk.summary.height);
+        chunk.occluders = build_chunk_occluders(chunk.voxels);
+
+        std::lock_guard lock(mutex);
+        finished.emplace_back(std::move(chunk));
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_CHUNKSTREAMER_HPP
+#define BUSINESS_GAME_CHUNKSTREAMER_HPP
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "voxel/ChunkSummary.hpp"
+#include "voxel/VoxelMesher.hpp"
+
+#define STREAM_WORKERS 2
+
+// A chunk built by a ChunkStreamer, ready to be uploaded
+struct StreamedChunk {
+    Int2 chunk_pos{};
+    VoxelChunk voxels{};
+    ChunkSummary summary;
+    std::vector<MaterialMesh> meshes; // CPU only, see upload_chunk_mesh()
+    std::vector<BoundingBox> occluders;
+};
+
+// Worker threads that generate chunks (or take saved ones) and build their meshes,
+// so the main thread only has to upload them. Chunks are built in the order they were requested.
+class ChunkStreamer {
+public:
+    explicit ChunkStreamer(int workers = STREAM_WORKERS);
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // Generated with VoxelMap::generate_chunk(), unless saved voxels are given
+    void request(Int2 chunk_pos, const VoxelChunk* saved = nullptr);
+    // Returns false if the chunk wasn't waiting anymore (it is being built or already finished)
+    bool cancel(Int2 chunk_pos);
+    // Moves at most max finished chunks to out
+    void collect(std::vector<StreamedChunk>& out, size_t max);
+
+private:
+    struct Request {
+        Int2 chunk_pos;
+        std::optional<VoxelChunk> saved;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::deque<Request> queue;
+    std::vector<StreamedChunk> finished;
+
+    void worker_loop();
+};
+
+
+#endif //BUSINESS_GAME_CHUNKSTREAMER_HPP
@@ -0,0 +1,51 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "voxel/ChunkSummary.hpp"
+
+#include <algorithm>
+
+static int getColumnTop(const VoxelChunk& chunk, const int x, const int y, const int below) {
+    for (int z = below - 1; z >= 0; z--) {
+        if (chunk[VoxelChunkLayout::index(x, y, z)] != 0) return z + 1;
+    }
+    return 0;
+}
+
+void ChunkSummary::rebuild(const VoxelChunk& chunk) {
+    solid_count = 0;
+    for (const VoxelID v : chunk) {
+        if (v != 0) solid_count++;
+    }
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            column_heights[x + y * CHUNK_SIZE] = static_cast<uint8_t>(getColumnTop(chunk, x, y, CHUNK_SIZE));
+        }
+    }
+    height = *std::max_element(column_heights.begin(), column_heights.end());
+    revision++;
+}
+
+void ChunkSummary::set_voxel(const VoxelChunk& chunk, const Int3 pos, const VoxelID old_id, const VoxelID new_id) {
+    if ((old_id == 0) == (new_id == 0)) {
+        // only the material changed
+        if (old_id != new_id) revision++;
+        return;
+    }
+
+    uint8_t& column = column_heights[pos.x + pos.y * CHUNK_SIZE];
+    if (new_id != 0) {
+        solid_count++;
+        column = std::max(column, static_cast<uint8_t>(pos.z + 1));
+        height = std::max(height, static_cast<int>(column));
+    } else {
+        solid_count--;
+        if (column == pos.z + 1) {
+            // the top of the column was removed, find the next one down
+            column = static_cast<uint8_t>(getColumnTop(chunk, pos.x, pos.y, pos.z));
+            if (height == pos.z + 1) height = *std::max_element(column_heights.begin(), column_heights.end());
+        }
+    }
+    revision++;
+}
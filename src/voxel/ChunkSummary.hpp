@@ -0,0 +1,32 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_CHUNKSUMMARY_HPP
+#define BUSINESS_GAME_CHUNKSUMMARY_HPP
+#include <array>
+#include <cstdint>
+#include "voxel/VoxelGrid.hpp"
+
+#define CHUNK_VOLUME VoxelChunkLayout::volume
+
+// Cheap answers about a chunk without touching its voxels.
+// Built once with rebuild(), then kept up to date voxel by voxel with set_voxel().
+struct ChunkSummary {
+    // Highest solid voxel + 1 of every (x, y) column, 0 if the column is empty
+    std::array<uint8_t, CHUNK_SIZE * CHUNK_SIZE> column_heights{};
+    int height = 0;      // max of column_heights
+    int solid_count = 0; // non-air voxels
+    unsigned int revision = 0; // bumped on every change
+
+    bool is_empty() const { return solid_count == 0; }
+    bool is_full() const { return solid_count == CHUNK_VOLUME; }
+    int get_column_height(int x, int y) const { return column_heights[x + y * CHUNK_SIZE]; }
+
+    void rebuild(const VoxelChunk& chunk);
+    // Call after chunk[pos] went from old_id to new_id
+    void set_voxel(const VoxelChunk& chunk, Int3 pos, VoxelID old_id, VoxelID new_id);
+};
+
+
+#endif //BUSINESS_GAME_CHUNKSUMMARY_HPP
@@ -5,6 +5,7 @@
 #include "SingleChunkGrid.hpp"
 
 #include "VoxelMesher.hpp"
+#include "VoxelRaycast.hpp"
 #include "game/main.hpp"
 
 SingleChunkGrid::SingleChunkGrid(const VoxelColourMap &voxel_colours) {
@@ -14,6 +15,7 @@ SingleChunkGrid::SingleChunkGrid(const VoxelColourMap &voxel_colours) {
     was_updated = true;
     data = VoxelChunk();
     model = {};
+    global::memory_tracker.allocate(MemoryTag::Chunks, sizeof(VoxelChunk));
 }
 
 Int2 SingleChunkGrid::get_size() {
@@ -21,20 +23,35 @@ Int2 SingleChunkGrid::get_size() {
 }
 
 VoxelID* SingleChunkGrid::get_voxel(Int3 grid_pos) {
-    return &data[grid_pos.x
-        + grid_pos.y * CHUNK_SIZE
-        + grid_pos.z * CHUNK_SIZE * CHUNK_SIZE];
+    return &data[VoxelChunkLayout::index(grid_pos.x, grid_pos.y, grid_pos.z)];
+}
+
+SingleChunkGrid::~SingleChunkGrid() {
+    if (model.has_value()) unindex_model(*model);
+    global::memory_tracker.free(MemoryTag::Chunks, sizeof(VoxelChunk));
 }
 
 void SingleChunkGrid::update_models() {
-    if (global::isInRenderDistance(transform.translation)) {
+    if (moved_since_indexed() && model.has_value()) index_model(*model);
+
+    const Matrix& world = get_world_matrix();
+    if (global::isInRenderDistance(Vector3{world.m12, world.m13, world.m14})) {
         if (was_updated) {
             auto meshes = build_chunk_mesh(data, Vector3{0.0,0.0,0.0}, 1.0f);
             auto new_model = build_chunk_model(meshes, *voxel_colours);
 
-            model = ModelInfo{true, new_model, transform};
+            if (model.has_value()) {
+                unload_voxel_model(model->model);
+                model_bytes -= model->bytes;
+            }
+            model = ModelInfo{true, new_model, identity(), get_model_bounds(new_model),
+                build_chunk_occluders(data)};
+            model->bytes = get_model_bytes(new_model);
+            model_bytes += model->bytes;
+            index_model(*model);
 
             was_updated = false;
+            revision++;
         }
     } else if (model.has_value()) {
         model->do_render = false;
@@ -44,9 +61,31 @@ void SingleChunkGrid::update_models() {
 std::vector<ModelInfo *> SingleChunkGrid::get_models() {
     auto out = std::vector<ModelInfo*>();
     if (model.has_value()) {
+        update_world_matrix(*model);
         out.emplace_back(&model.value());
     } else {
         out.emplace_back(nullptr);
     }
     return out;
 }
+
+bool SingleChunkGrid::raycast(const Ray& ray, const float max_distance, VoxelHit& hit) {
+    float t_enter, t_exit;
+    int axis;
+    constexpr float side = CHUNK_SIZE;
+    if (!clip_ray_to_box(ray, Vector3{0, 0, 0}, Vector3{side, side, side}, t_enter, t_exit, axis)) return false;
+    t_exit = std::min(t_exit, max_distance);
+
+    for (VoxelDDA dda(ray, t_enter, axis); dda.t <= t_exit; dda.next()) {
+        const Int3 cell = dda.get_cell();
+        if (cell.x < 0 || cell.y < 0 || cell.z < 0) continue;
+        if (cell.x >= CHUNK_SIZE || cell.y >= CHUNK_SIZE || cell.z >= CHUNK_SIZE) continue;
+        if (*get_voxel(cell) == 0) continue;
+
+        hit.voxel = cell;
+        hit.normal = dda.get_normal();
+        hit.distance = dda.t;
+        return true;
+    }
+    return false;
+}
@@ -8,16 +8,17 @@
 
 class SingleChunkGrid final : public VoxelGrid {
 public:
-    Transform transform;
     VoxelChunk data;
     bool was_updated;
 
     explicit SingleChunkGrid(const VoxelColourMap &voxel_colours);
+    ~SingleChunkGrid() override;
 
     Int2 get_size() override;
     VoxelID *get_voxel(Int3 grid_pos) override;
     void update_models() override;
     std::vector<ModelInfo*> get_models() override;
+    bool raycast(const Ray& ray, float max_distance, VoxelHit& hit) override;
 private:
     Int2 size;
     std::optional<ModelInfo> model;
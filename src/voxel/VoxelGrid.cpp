@@ -0,0 +1,76 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "voxel/VoxelGrid.hpp"
+
+#include <cstring>
+#include <raymath.h>
+#include "render/Frustum.hpp"
+#include "render/SpatialIndex.hpp"
+#include "game/main.hpp"
+
+const Matrix& VoxelGrid::get_world_matrix() const {
+    const Matrix* parent_matrix = parent != nullptr ? &parent->get_world_matrix() : nullptr;
+    const unsigned int parent_revision = parent != nullptr ? parent->transform_revision : 0;
+
+    const bool changed = transform_revision == 0
+        || std::memcmp(&world_transform, &transform, sizeof(Transform)) != 0
+        || world_parent != parent
+        || world_parent_revision != parent_revision
+        || (parent == nullptr && world_voxel_scale != global::voxel_scale);
+    if (!changed) return world_matrix;
+
+    // Scale -> Rotate -> Translate (same order as DrawModelEx), then the parent
+    const Matrix local = MatrixMultiply(MatrixMultiply(
+        MatrixScale(transform.scale.x, transform.scale.y, transform.scale.z),
+        QuaternionToMatrix(transform.rotation)),
+        MatrixTranslate(transform.translation.x, transform.translation.y, transform.translation.z));
+    const float s = global::voxel_scale;
+    world_matrix = MatrixMultiply(local, parent_matrix != nullptr ? *parent_matrix : MatrixScale(s, s, s));
+
+    world_transform = transform;
+    world_parent = parent;
+    world_parent_revision = parent_revision;
+    world_voxel_scale = s;
+    transform_revision++;
+    return world_matrix;
+}
+
+unsigned int VoxelGrid::get_transform_revision() const {
+    get_world_matrix();
+    return transform_revision;
+}
+
+void VoxelGrid::update_world_matrix(ModelInfo& model) const {
+    const Matrix& grid_matrix = get_world_matrix();
+    if (model.world_revision == transform_revision) return;
+
+    const Transform& t = model.transform;
+    const Matrix local = MatrixMultiply(MatrixMultiply(
+        MatrixScale(t.scale.x, t.scale.y, t.scale.z),
+        QuaternionToMatrix(t.rotation)),
+        MatrixTranslate(t.translation.x, t.translation.y, t.translation.z));
+    model.world_matrix = MatrixMultiply(model.model.transform, MatrixMultiply(local, grid_matrix));
+    model.world_bounds = transformBoundingBox(model.bounds, model.world_matrix);
+    model.world_revision = transform_revision;
+}
+
+void VoxelGrid::index_model(ModelInfo& model) {
+    update_world_matrix(model);
+    if (spatial_index == nullptr) return;
+    if (model.model.meshCount == 0 && !model.evicted) spatial_index->remove(&model);
+    else spatial_index->update(&model, this);
+}
+
+void VoxelGrid::unindex_model(const ModelInfo& model) {
+    if (spatial_index != nullptr) spatial_index->remove(&model);
+}
+
+bool VoxelGrid::moved_since_indexed() {
+    const unsigned int transform = get_transform_revision();
+    if (transform == indexed_revision && indexed_in == spatial_index) return false;
+    indexed_revision = transform;
+    indexed_in = spatial_index;
+    return true;
+}
@@ -5,13 +5,37 @@
 #ifndef BUSINESS_GAME_VOXELGRID_HPP
 #define BUSINESS_GAME_VOXELGRID_HPP
 #include <raylib.h>
+#include <array>
 #include <map>
 
 // REMINDER: Z goes UP/DOWN
 
+// Side of the chunks the game uses, can be changed at configure time with -DCHUNK_SIZE=32
+#ifndef CHUNK_SIZE
 #define CHUNK_SIZE 16
+#endif
+// column heights are stored as uint8_t, occluder cells are 4 voxels wide
+static_assert(CHUNK_SIZE <= 255 && CHUNK_SIZE % 4 == 0, "unsupported CHUNK_SIZE");
+
 using VoxelID = uint8_t;
-using VoxelChunk = std::array<VoxelID,CHUNK_SIZE*CHUNK_SIZE*CHUNK_SIZE>;
+
+// Index math of a cube of N^3 voxels, stored x first, then y, then z
+template<int N>
+struct ChunkLayout {
+    static constexpr int size = N;
+    static constexpr int area = N * N;
+    static constexpr int volume = N * N * N;
+
+    static constexpr int index(const int x, const int y, const int z) { return x + y * N + z * area; }
+    static constexpr bool contains(const int x, const int y, const int z) {
+        return 0 <= x && x < N && 0 <= y && y < N && 0 <= z && z < N;
+    }
+};
+
+template<int N>
+using BasicVoxelChunk = std::array<VoxelID, ChunkLayout<N>::volume>;
+using VoxelChunkLayout = ChunkLayout<CHUNK_SIZE>;
+using VoxelChunk = BasicVoxelChunk<CHUNK_SIZE>;
 using VoxelColourMap = std::shared_ptr<std::map<VoxelID, Color>>;
 
 struct Int2 {
@@ -50,13 +74,42 @@ struct Int3 {
 struct ModelInfo {
     bool do_render;
     Model model;
-    Transform transform;
+    Transform transform;  // relative to its grid
+    BoundingBox bounds{}; // of the meshes, in model space
+    std::vector<BoundingBox> occluders{}; // solid boxes inside the model, in model space
+    size_t bytes = 0;       // of its meshes, see get_model_bytes()
+    uint64_t last_used = 0; // global::frame it was last inside the camera frustum
+    bool evicted = false;   // model unloaded to stay within the memory budget, rebuilt once it is back in view
+    // Render space, kept up to date by VoxelGrid::update_world_matrix()
+    Matrix world_matrix{};
+    BoundingBox world_bounds{};
+    unsigned int world_revision = 0; // grid's transform_revision they were computed at, 0 if never
+};
+
+class VoxelGrid;
+class SpatialIndex;
+
+// Result of a raycast, see VoxelGrid::raycast() and raycast_voxel_grids()
+struct VoxelHit {
+    VoxelGrid* grid = nullptr;
+    Int3 voxel{};          // grid coordinates
+    Int3 normal{};         // of the face that was hit, {0,0,0} if the ray started inside the voxel
+    float distance = 0.0f; // along the ray, in the units of its direction
+    Vector3 point{};       // world space, only set by raycast_voxel_grids()
 };
 
 class VoxelGrid {
 public:
+    // Relative to the parent grid, or to the world if there is none
     Transform transform;
+    VoxelGrid* parent = nullptr;
+    // If set, the grid keeps all its models in there (with their world bounds) from its next update_models()
+    SpatialIndex* spatial_index = nullptr;
     VoxelColourMap voxel_colours;
+    // Bumped every time one of the grid's models is rebuilt
+    unsigned int revision = 0;
+    // Sum of the bytes of all its models
+    size_t model_bytes = 0;
 
     virtual Int2 get_size() = 0;
     virtual VoxelID* get_voxel(Int3 grid_pos) = 0;
@@ -67,6 +120,18 @@ public:
     // list where every node has an array of ModelInfos that are
     // managed by their respective grid
     virtual std::vector<ModelInfo*> get_models() = 0;
+    // Finds the first solid voxel along the ray, which is in grid space (see VoxelRaycast.hpp).
+    // Only voxels closer than max_distance count.
+    virtual bool raycast(const Ray& ray, float max_distance, VoxelHit& hit) = 0;
+
+    // Grid space -> render space: transform, then the parent's world matrix (or voxel_scale if there
+    // is no parent). Cached, only recomputed after transform, the parent or voxel_scale changed.
+    const Matrix& get_world_matrix() const;
+    // Bumped every time the world matrix changes
+    unsigned int get_transform_revision() const;
+    // Recomputes model.world_matrix and world_bounds if the grid moved since they were computed.
+    // The grids call it from get_models(), so the models they return are always up to date.
+    void update_world_matrix(ModelInfo& model) const;
 
     virtual ~VoxelGrid() = default;
 
@@ -81,6 +146,24 @@ protected:
         int m = a % b;
         return (m < 0) ? (m + (b > 0 ? b : -b)) : m;
     }
+
+    // Adds the model to spatial_index, or moves it there after it was rebuilt.
+    // Models without meshes are left out, unless they were evicted (they have to be found to come back).
+    void index_model(ModelInfo& model);
+    // Call before the model is destroyed
+    void unindex_model(const ModelInfo& model);
+    // True once after every move of the grid (or a new spatial_index), all its models have to be indexed again
+    bool moved_since_indexed();
+
+private:
+    const SpatialIndex* indexed_in = nullptr;
+    unsigned int indexed_revision = 0;
+    mutable Matrix world_matrix{};
+    mutable Transform world_transform{};   // transform the cache was computed from
+    mutable float world_voxel_scale = 0.0f;
+    mutable const VoxelGrid* world_parent = nullptr;
+    mutable unsigned int world_parent_revision = 0;
+    mutable unsigned int transform_revision = 0; // 0 until the first get_world_matrix()
 };
 
 
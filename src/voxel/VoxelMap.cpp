@@ -4,97 +4,203 @@
 
 #include "voxel/VoxelMap.hpp"
 
+#include <algorithm>
 #include <raymath.h>
 
 #include "voxel/VoxelMesher.hpp"
+#include "voxel/ChunkStreamer.hpp"
+#include "voxel/VoxelRaycast.hpp"
 #include "PerlinNoise.hpp"
 #include "game/main.hpp"
 
 VoxelMap::VoxelMap(const uint32_t size_x, const uint32_t size_y) {
     this->size = Int2(size_x, size_y);
     this->chunk_count = Int2(
-        size_x / 16 + (size_x % 16 ? 1 : 0),
-        size_y / 16 + (size_y % 16 ? 1 : 0));
+        size_x / CHUNK_SIZE + (size_x % CHUNK_SIZE ? 1 : 0),
+        size_y / CHUNK_SIZE + (size_y % CHUNK_SIZE ? 1 : 0));
+    this->chunk_max = chunk_count;
 
     this->transform = identity();
+    set_colours();
 
+    this->chunks = std::map<Int2, VoxelChunk>();
+    for (int ix = 0; ix < chunk_count.x; ++ix) {
+        for (int iy = 0; iy < chunk_count.y; ++iy) {
+            VoxelChunk& chunk = chunks[Int2(ix, iy)];
+            generate_chunk(chunk, Int2(ix, iy), size);
+            chunk_summaries[Int2(ix, iy)].rebuild(chunk);
+            dirty_chunks.insert(Int2(ix, iy));
+        }
+    }
+    track_chunk_memory();
+}
+
+VoxelMap::VoxelMap() {
+    this->size = Int2(0, 0);
+    this->chunk_count = Int2(0, 0);
+    this->transform = identity();
+    set_colours();
+    this->streamer = std::make_unique<ChunkStreamer>();
+}
+
+void VoxelMap::set_colours() {
     this->voxel_colours = std::make_shared<std::map<VoxelID, Color>>();
     auto colorMap = this->voxel_colours.get();
     colorMap->insert(std::pair<VoxelID, Color>(0, RED)); // air, should not be seen
     colorMap->insert(std::pair<VoxelID, Color>(1, BEIGE));
     colorMap->insert(std::pair<VoxelID, Color>(2, DARKGREEN));
     colorMap->insert(std::pair<VoxelID, Color>(3, YELLOW));
+}
 
-    this->chunks = std::map<Int2, VoxelChunk>();
-    for (int ix = 0; ix < chunk_count.x; ++ix) {
-        for (int iy = 0; iy < chunk_count.y; ++iy) {
-            chunks[Int2(ix, iy)] = VoxelChunk{};
-            chunk_was_updated[Int2(ix, iy)] = true;
-        }
-    }
-
-    const siv::PerlinNoise::seed_type seed = 123456u;
-    const siv::PerlinNoise perlin{ seed };
+void VoxelMap::generate_chunk(VoxelChunk& chunk, const Int2 chunk_pos, const Int2 limit) {
+    static const siv::PerlinNoise::seed_type seed = 123456u;
+    static const siv::PerlinNoise perlin{ seed };
 
-    for (int i = 0; i < size_x * size_y; i++) {
-        auto ix = i % size_x, iy = i / size_x;
+    chunk.fill(0);
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            const int ix = chunk_pos.x * CHUNK_SIZE + x, iy = chunk_pos.y * CHUNK_SIZE + y;
+            if (ix >= limit.x || iy >= limit.y) continue;
 
-        // Perlin Noise Generation
-        float noise = perlin.noise2D(ix * 0.05, iy * 0.05) * CHUNK_SIZE;
-        int height = std::clamp(static_cast<int>(noise), 0, CHUNK_SIZE - 1);
+            // Perlin Noise Generation
+            float noise = perlin.noise2D(ix * 0.05, iy * 0.05) * TERRAIN_HEIGHT;
+            int height = std::clamp(static_cast<int>(noise), 0, std::min(TERRAIN_HEIGHT, CHUNK_SIZE) - 1);
 
-        // Lift the edges to see the clear limit of the chunks
-        // auto cx = ix % 16, cy = iy % 16;
-        // bool is_edge = cx == 0 || cy == 0;// || cx == CHUNK_SIZE -2 || cy == CHUNK_SIZE - 2;
-        // int height = is_edge ? 3 : 1;
+            // Lift the edges to see the clear limit of the chunks
+            // bool is_edge = x == 0 || y == 0;
+            // int height = is_edge ? 3 : 1;
 
-        for (int j = 0; j <= height; j++) {
-            VoxelID voxel_type = j < 3 ? 1 : 2;
-            auto v = VoxelMap::get_voxel(Int3(ix, iy, j));
-            *v = voxel_type;
+            for (int j = 0; j <= height; j++) {
+                VoxelID voxel_type = j < 3 ? 1 : 2;
+                *get_chunk_voxel(chunk, Int3(x, y, j)) = voxel_type;
+            }
         }
     }
 }
 
 VoxelMap::~VoxelMap() {
     for (auto it = chunk_models.begin(); it != chunk_models.end(); ++it) {
-        UnloadModel(it->second.model);
+        unindex_model(it->second);
+        unload_chunk_model(it->second);
     }
     chunk_models.clear();
+    track_chunk_memory(true);
 }
 
 void VoxelMap::update_models() {
-    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
-        auto chunk_pos = it->first;
-        auto chunk = &it->second;
-        auto chunk_model = chunk_models.find(chunk_pos);
-
-        // calculating the position of the chunk in render space
-        auto model_transform = transform;
-        model_transform.translation += Vector3{
-            static_cast<float>(it->first.x) * (CHUNK_SIZE - 1),
-            0.0,
-            static_cast<float>(it->first.y) * (CHUNK_SIZE - 1)
-        };
-
-        // render distance check
-        if (chunk_model != chunk_models.end() && global::limit_render_distance) {
-            chunk_model->second.do_render = global::isInRenderDistance(model_transform.translation);
+    if (moved_since_indexed()) {
+        for (auto& [chunk_pos, model_info] : chunk_models) index_model(model_info);
+    }
+
+    // Evicted models that were in view last frame come back
+    for (auto it = evicted_chunks.begin(); it != evicted_chunks.end();) {
+        if (chunk_models[*it].last_used + 1 >= global::frame) {
+            dirty_chunks.insert(*it);
+            it = evicted_chunks.erase(it);
+        } else {
+            ++it;
         }
+    }
+
+    if (!dirty_chunks.empty()) {
+        // Closest first, chunks out of view after all the ones in view
+        const Matrix& world_matrix = get_world_matrix();
+        const Vector3 half_chunk = {CHUNK_SIZE / 2.0f, CHUNK_SIZE / 2.0f, CHUNK_SIZE / 2.0f};
+        remesh_queue.clear();
+        for (const Int2 chunk_pos : dirty_chunks) {
+            const auto chunk_model = chunk_models.find(chunk_pos);
+            const bool in_view = chunk_model == chunk_models.end() || chunk_model->second.last_used + 1 >= global::frame;
+            const Vector3 centre = Vector3Transform(Vector3Add(get_chunk_offset(chunk_pos), half_chunk), world_matrix);
+            const float distance = Vector3DistanceSqr(centre, global::camera.position);
+            remesh_queue.emplace_back(!in_view, distance, chunk_pos);
+        }
+        const size_t count = remesh_budget > 0 ? std::min<size_t>(remesh_budget, remesh_queue.size()) : remesh_queue.size();
+        std::partial_sort(remesh_queue.begin(), remesh_queue.begin() + static_cast<long>(count), remesh_queue.end());
+
+        for (size_t i = 0; i < count; i++) {
+            const Int2 chunk_pos = std::get<2>(remesh_queue[i]);
+            dirty_chunks.erase(chunk_pos);
+            evicted_chunks.erase(chunk_pos);
+            const auto chunk = chunks.find(chunk_pos);
+            if (chunk == chunks.end()) continue;
+
+            const auto chunk_model = chunk_models.find(chunk_pos);
+            if (chunk_model != chunk_models.end()) {
+                if (chunk_model->second.evicted) model_stats.rebuilt++;
+                unload_chunk_model(chunk_model->second);
+            }
+
+            // the chunk's place in the grid, get_models() adds the grid's world matrix
+            auto model_transform = identity();
+            model_transform.translation = get_chunk_offset(chunk_pos);
 
-        if (chunk_was_updated[chunk_pos]) {
-            auto meshes = build_chunk_mesh(*chunk, Vector3{0.0,0.0,0.0}, 1.0f);
+            // nothing above the summary's height to mesh
+            const int height = chunk_summaries[chunk_pos].height;
+            auto meshes = build_chunk_mesh(chunk->second, Vector3{0.0,0.0,0.0}, 1.0f, height);
             auto new_model = build_chunk_model(meshes, *voxel_colours);
 
-            chunk_models[chunk_pos] = ModelInfo{true, new_model, model_transform};
-            chunk_was_updated[chunk_pos] = false;
+            ModelInfo& model_info = chunk_models[chunk_pos];
+            model_info = ModelInfo{true, new_model, model_transform, get_model_bounds(new_model),
+                build_chunk_occluders(chunk->second)};
+            model_info.bytes = get_model_bytes(new_model);
+            model_info.last_used = global::frame;
+            model_bytes += model_info.bytes;
+            index_model(model_info);
+            revision++;
         }
+        model_stats.remesh_backlog = static_cast<int>(dirty_chunks.size());
     }
+
+    enforce_model_budget();
+}
+
+void VoxelMap::unload_chunk_model(ModelInfo& model_info) {
+    if (model_info.evicted) return;
+    unload_voxel_model(model_info.model);
+    model_bytes -= model_info.bytes;
+    model_info.bytes = 0;
+}
+
+void VoxelMap::enforce_model_budget() {
+    if (model_budget == 0 || model_bytes <= model_budget) return;
+
+    // Least recently seen first, the ones in view (this frame or the last) are never evicted
+    std::vector<std::pair<uint64_t, Int2>> candidates;
+    for (const auto& [chunk_pos, model_info] : chunk_models) {
+        if (model_info.evicted || model_info.bytes == 0 || model_info.last_used + 1 >= global::frame) continue;
+        candidates.emplace_back(model_info.last_used, chunk_pos);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& [last_used, chunk_pos] : candidates) {
+        if (model_bytes <= model_budget) break;
+        ModelInfo& model_info = chunk_models[chunk_pos];
+        unload_chunk_model(model_info);
+        model_info.evicted = true;
+        evicted_chunks.insert(chunk_pos);
+        model_stats.evictions++;
+        revision++;
+    }
+}
+
+ModelMemoryStats VoxelMap::get_model_stats() const {
+    ModelMemoryStats stats = model_stats;
+    stats.bytes = model_bytes;
+    stats.budget = model_budget;
+    for (const auto& [chunk_pos, model_info] : chunk_models) {
+        if (model_info.evicted) stats.evicted++;
+        else stats.models++;
+    }
+    return stats;
 }
 
 std::vector<ModelInfo*> VoxelMap::get_models() {
     auto out = std::vector<ModelInfo*>{};
     for (auto it = chunk_models.begin(); it != chunk_models.end(); ++it) {
+        update_world_matrix(it->second);
+        // render distance check, from the chunk's origin in render space
+        const Matrix& m = it->second.world_matrix;
+        it->second.do_render = global::isInRenderDistance(Vector3{m.m12, m.m13, m.m14});
         if (it->second.do_render) {
             out.emplace_back(&it->second);
         }
@@ -127,10 +233,276 @@ VoxelID* VoxelMap::get_voxel(Int3 pos) {
     return get_chunk_voxel(*chunk, chunk_pos);
 }
 
+bool VoxelMap::set_voxel(const Int3 pos, const VoxelID id) {
+    if (pos.z < 0 || pos.z >= CHUNK_SIZE) return false;
+    const Int2 chunk_pos = {floordiv(pos.x, CHUNK_SIZE), floordiv(pos.y, CHUNK_SIZE)};
+    auto chunk = chunks.find(chunk_pos);
+    if (chunk == chunks.end()) return false;
+
+    const Int3 local = {floormod(pos.x, CHUNK_SIZE), floormod(pos.y, CHUNK_SIZE), pos.z};
+    VoxelID* voxel = get_chunk_voxel(chunk->second, local);
+    const VoxelID old_id = *voxel;
+    if (old_id == id) return true;
+
+    *voxel = id;
+    chunk_summaries[chunk_pos].set_voxel(chunk->second, local, old_id, id);
+    dirty_chunks.insert(chunk_pos);
+    if (streamer) edited_chunks.insert(chunk_pos);
+    return true;
+}
+
+void VoxelMap::stream_around(const Vector3 position) {
+    if (!streamer) return;
+
+    // Back into grid space, where the ground is X and Z
+    const Vector3 local = Vector3Transform(position, MatrixInvert(get_world_matrix()));
+    const Int2 centre = {
+        floordiv(static_cast<int>(floorf(local.x)), CHUNK_SIZE),
+        floordiv(static_cast<int>(floorf(local.z)), CHUNK_SIZE),
+    };
+
+    if (stream_offsets_radius != stream_radius) {
+        stream_offsets.clear();
+        for (int y = -stream_radius; y <= stream_radius; y++) {
+            for (int x = -stream_radius; x <= stream_radius; x++) {
+                if (x * x + y * y <= stream_radius * stream_radius) stream_offsets.emplace_back(Int2{x, y});
+            }
+        }
+        std::stable_sort(stream_offsets.begin(), stream_offsets.end(), [](const Int2 a, const Int2 b) {
+            return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;
+        });
+        stream_offsets_radius = stream_radius;
+    }
+
+    // Evict what's too far, loaded or not
+    const int keep = stream_radius + STREAM_EVICT_MARGIN;
+    auto is_far = [&](const Int2 chunk_pos) {
+        const int dx = chunk_pos.x - centre.x, dy = chunk_pos.y - centre.y;
+        return dx * dx + dy * dy > keep * keep;
+    };
+    std::vector<Int2> far;
+    for (const auto& [chunk_pos, chunk] : chunks) {
+        if (is_far(chunk_pos)) far.emplace_back(chunk_pos);
+    }
+    for (const Int2 chunk_pos : far) evict_chunk(chunk_pos);
+    for (auto it = pending_chunks.begin(); it != pending_chunks.end();) {
+        if (!is_far(*it)) {
+            ++it;
+            continue;
+        }
+        // if it is already being built, the result is thrown away when it arrives
+        streamer->cancel(*it);
+        it = pending_chunks.erase(it);
+    }
+
+    // Request the missing ones, closest first
+    for (const Int2 offset : stream_offsets) {
+        if (pending_chunks.size() >= STREAM_MAX_IN_FLIGHT) break;
+        const Int2 chunk_pos = {centre.x + offset.x, centre.y + offset.y};
+        if (chunks.contains(chunk_pos) || pending_chunks.contains(chunk_pos)) continue;
+        const auto saved = saved_chunks.find(chunk_pos);
+        streamer->request(chunk_pos, saved != saved_chunks.end() ? &saved->second : nullptr);
+        pending_chunks.insert(chunk_pos);
+    }
+
+    // Upload a few of the finished ones
+    std::vector<StreamedChunk> ready;
+    streamer->collect(ready, STREAM_UPLOADS_PER_FRAME);
+    for (StreamedChunk& streamed : ready) {
+        const Int2 chunk_pos = streamed.chunk_pos;
+        if (pending_chunks.erase(chunk_pos) == 0) {
+            // evicted while it was being built
+            unload_chunk_mesh(streamed.meshes);
+            continue;
+        }
+        upload_chunk_mesh(streamed.meshes);
+        auto new_model = build_chunk_model(streamed.meshes, *voxel_colours);
+        auto model_transform = identity();
+        model_transform.translation = get_chunk_offset(chunk_pos);
+
+        chunks[chunk_pos] = streamed.voxels;
+        chunk_summaries[chunk_pos] = streamed.summary;
+        ModelInfo& model_info = chunk_models[chunk_pos];
+        model_info = ModelInfo{true, new_model, model_transform, get_model_bounds(new_model),
+            std::move(streamed.occluders)};
+        model_info.bytes = get_model_bytes(new_model);
+        model_info.last_used = global::frame;
+        model_bytes += model_info.bytes;
+        index_model(model_info);
+        // still different from the generated terrain, has to be saved again when evicted
+        if (saved_chunks.erase(chunk_pos)) edited_chunks.insert(chunk_pos);
+        else stream_stats.generated++;
+        revision++;
+    }
+
+    if (!far.empty() || !ready.empty()) {
+        update_chunk_bounds();
+        track_chunk_memory();
+    }
+}
+
+void VoxelMap::track_chunk_memory(const bool release) {
+    // Only the chunks themselves, the map nodes around them are small next to one
+    const size_t voxel_bytes = release ? 0 : (chunks.size() + saved_chunks.size()) * sizeof(VoxelChunk);
+    const size_t summary_bytes = release ? 0 : chunk_summaries.size() * sizeof(ChunkSummary);
+    global::memory_tracker.resize(MemoryTag::Chunks, tracked_voxel_bytes, voxel_bytes);
+    global::memory_tracker.resize(MemoryTag::ChunkSummaries, tracked_summary_bytes, summary_bytes);
+    tracked_voxel_bytes = voxel_bytes;
+    tracked_summary_bytes = summary_bytes;
+}
+
+void VoxelMap::evict_chunk(const Int2 chunk_pos) {
+    const auto model = chunk_models.find(chunk_pos);
+    if (model != chunk_models.end()) {
+        unindex_model(model->second);
+        unload_chunk_model(model->second);
+        chunk_models.erase(model);
+    }
+    if (edited_chunks.erase(chunk_pos)) saved_chunks[chunk_pos] = chunks[chunk_pos];
+    chunks.erase(chunk_pos);
+    chunk_summaries.erase(chunk_pos);
+    dirty_chunks.erase(chunk_pos);
+    evicted_chunks.erase(chunk_pos);
+    stream_stats.evicted++;
+    revision++;
+}
+
+void VoxelMap::update_chunk_bounds() {
+    if (chunks.empty()) {
+        chunk_min = chunk_max = Int2{0, 0};
+        return;
+    }
+    chunk_min = Int2{INT32_MAX, INT32_MAX};
+    chunk_max = Int2{INT32_MIN, INT32_MIN};
+    for (const auto& [chunk_pos, chunk] : chunks) {
+        chunk_min = Int2{std::min(chunk_min.x, chunk_pos.x), std::min(chunk_min.y, chunk_pos.y)};
+        chunk_max = Int2{std::max(chunk_max.x, chunk_pos.x + 1), std::max(chunk_max.y, chunk_pos.y + 1)};
+    }
+}
+
+StreamStats VoxelMap::get_stream_stats() const {
+    StreamStats stats = stream_stats;
+    stats.loaded = static_cast<int>(chunks.size());
+    stats.pending = static_cast<int>(pending_chunks.size());
+    stats.saved = static_cast<int>(saved_chunks.size());
+    return stats;
+}
+
+const ChunkSummary* VoxelMap::get_chunk_summary(const Int2 chunk_pos) const {
+    const auto summary = chunk_summaries.find(chunk_pos);
+    if (summary == chunk_summaries.end()) return nullptr;
+    return &summary->second;
+}
+
+int VoxelMap::get_surface_height(const Int2 column) const {
+    const ChunkSummary* summary = get_chunk_summary({floordiv(column.x, CHUNK_SIZE), floordiv(column.y, CHUNK_SIZE)});
+    if (summary == nullptr) return 0;
+    return summary->get_column_height(floormod(column.x, CHUNK_SIZE), floormod(column.y, CHUNK_SIZE));
+}
+
 VoxelID* VoxelMap::get_chunk_voxel(VoxelChunk& chunk, const Int3 pos) {
-    return &chunk[pos.x
-        + pos.y * CHUNK_SIZE
-        + pos.z * CHUNK_SIZE * CHUNK_SIZE];
+    return &chunk[VoxelChunkLayout::index(pos.x, pos.y, pos.z)];
+}
+
+Vector3 VoxelMap::get_chunk_offset(const Int2 chunk_pos) const {
+    return Vector3{
+        static_cast<float>(chunk_pos.x) * CHUNK_SIZE,
+        0.0,
+        static_cast<float>(chunk_pos.y) * CHUNK_SIZE
+    };
+}
+
+Vector3 VoxelMap::get_voxel_position(const Int3 pos) const {
+    // Map (x,y,z) -> Render (X=x, Y=z, Z=y), same as the mesher
+    const Vector3 local = {
+        static_cast<float>(pos.x) + 0.5f,
+        static_cast<float>(pos.z) + 0.5f,
+        static_cast<float>(pos.y) + 0.5f,
+    };
+    return apply_transform(local, transform);
+}
+
+bool VoxelMap::raycast(const Ray& ray, const float max_distance, VoxelHit& hit) {
+    const Vector3 map_min = {
+        static_cast<float>(chunk_min.x * CHUNK_SIZE),
+        static_cast<float>(chunk_min.y * CHUNK_SIZE),
+        0.0f,
+    };
+    const Vector3 map_max = {
+        static_cast<float>(chunk_max.x * CHUNK_SIZE),
+        static_cast<float>(chunk_max.y * CHUNK_SIZE),
+        static_cast<float>(CHUNK_SIZE),
+    };
+    float t, t_end;
+    int axis;
+    if (!clip_ray_to_box(ray, map_min, map_max, t, t_end, axis)) return false;
+    t_end = std::min(t_end, max_distance);
+
+    const float origin[2] = {ray.position.x, ray.position.y};
+    const float dir[2] = {ray.direction.x, ray.direction.y};
+
+    while (t <= t_end) {
+        VoxelDDA dda(ray, t, axis);
+        const Int2 chunk_pos = {floordiv(dda.cell[0], CHUNK_SIZE), floordiv(dda.cell[1], CHUNK_SIZE)};
+        if (dda.cell[2] < 0) return false; // left through the bottom
+
+        // where the ray leaves this chunk's column
+        float t_leave = INFINITY;
+        int leave_axis = -1;
+        const int chunk_xy[2] = {chunk_pos.x, chunk_pos.y};
+        for (int i = 0; i < 2; i++) {
+            if (dda.step[i] == 0) continue;
+            const int boundary = (dda.step[i] > 0 ? chunk_xy[i] + 1 : chunk_xy[i]) * CHUNK_SIZE;
+            const float t_boundary = (static_cast<float>(boundary) - origin[i]) / dir[i];
+            if (t_boundary < t_leave) {
+                t_leave = t_boundary;
+                leave_axis = i;
+            }
+        }
+
+        const auto chunk = chunks.find(chunk_pos);
+        const ChunkSummary* summary = get_chunk_summary(chunk_pos);
+        const int top = (summary != nullptr) ? summary->height : CHUNK_SIZE;
+        if (chunk == chunks.end() || top == 0) {
+            // nothing in this chunk
+            t = t_leave;
+            axis = leave_axis;
+            continue;
+        }
+        if (dda.cell[2] >= top) {
+            // above the terrain, skip straight to where the ray comes down to it
+            if (ray.direction.z < 0.0f) {
+                const float t_down = (static_cast<float>(top) - ray.position.z) / ray.direction.z;
+                if (t_down < t_leave) {
+                    t = t_down;
+                    axis = 2;
+                    continue;
+                }
+            }
+            t = t_leave;
+            axis = leave_axis;
+            continue;
+        }
+
+        // voxel by voxel until the ray hits something or leaves the terrain of this chunk
+        for (; dda.t <= t_end; dda.next()) {
+            const Int3 cell = dda.get_cell();
+            if (cell.z < 0 || cell.z >= top) break;
+            if (floordiv(cell.x, CHUNK_SIZE) != chunk_pos.x || floordiv(cell.y, CHUNK_SIZE) != chunk_pos.y) break;
+
+            const Int3 local = {floormod(cell.x, CHUNK_SIZE), floormod(cell.y, CHUNK_SIZE), cell.z};
+            if (summary != nullptr && local.z >= summary->get_column_height(local.x, local.y)) continue;
+            if (*get_chunk_voxel(chunk->second, local) == 0) continue;
+
+            hit.voxel = cell;
+            hit.normal = dda.get_normal();
+            hit.distance = dda.t;
+            return true;
+        }
+        t = dda.t;
+        axis = dda.axis;
+    }
+    return false;
 }
 
 Int2 VoxelMap::get_size() {
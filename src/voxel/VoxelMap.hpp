@@ -5,31 +5,129 @@
 #ifndef BUSINESS_GAME_GAMEMAP_HPP
 #define BUSINESS_GAME_GAMEMAP_HPP
 #include <map>
+#include <memory>
+#include <set>
+#include <tuple>
 #include "voxel/VoxelGrid.hpp"
+#include "voxel/ChunkSummary.hpp"
+
+#define STREAM_RADIUS 8           // chunks around the camera that are kept loaded
+#define STREAM_EVICT_MARGIN 2     // chunks are only evicted this much further out, so they don't flicker in and out
+#define STREAM_MAX_IN_FLIGHT 32   // chunks requested from the streamer but not loaded yet
+#define STREAM_UPLOADS_PER_FRAME 4
+#define CHUNK_MODEL_BUDGET (64 * 1024 * 1024) // bytes of chunk meshes, see VoxelMap::model_budget
+#define CHUNK_REMESH_BUDGET 8 // chunks remeshed per update_models()
+#define TERRAIN_HEIGHT 16     // of the generated hills, the same whatever CHUNK_SIZE is
+
+class ChunkStreamer;
+
+struct StreamStats {
+    int loaded = 0;  // chunks
+    int pending = 0; // requested, not loaded yet
+    int saved = 0;   // edited chunks that were evicted, kept in memory
+    int generated = 0;
+    int evicted = 0;
+};
+
+struct ModelMemoryStats {
+    size_t bytes = 0;  // of the loaded chunk models
+    size_t budget = 0;
+    int models = 0;    // loaded
+    int evicted = 0;   // unloaded to stay within the budget, right now
+    int evictions = 0; // since the start
+    int rebuilt = 0;   // evicted models rebuilt because they came back into view
+    int remesh_backlog = 0; // dirty chunks left over by the last update_models()
+};
 
 class VoxelMap final : public VoxelGrid {
 
 public:
     std::map<Int2, VoxelChunk> chunks;
-    std::map<Int2, bool> chunk_was_updated;
+    // Chunks waiting to be remeshed by update_models()
+    std::set<Int2> dirty_chunks;
     std::map<Int2, ModelInfo> chunk_models;
+    // Kept up to date by set_voxel(), edits straight through get_voxel() don't update them
+    std::map<Int2, ChunkSummary> chunk_summaries;
 
+    // Chunks within stream_around()'s radius, streaming maps only
+    int stream_radius = STREAM_RADIUS;
+    // Once the chunk models take more than this, the ones that have been out of view
+    // the longest are unloaded by update_models(). 0 for no limit.
+    size_t model_budget = CHUNK_MODEL_BUDGET;
+    // Dirty chunks remeshed per update_models(), closest to the camera first. 0 for no limit.
+    int remesh_budget = CHUNK_REMESH_BUDGET;
+
+    // Generates the whole map up front
     VoxelMap(uint32_t size_x, uint32_t size_y);
+    // Streaming map: unbounded, starts empty and only holds the chunks around the last stream_around().
+    // get_size() and get_chunk_count() are 0 for it.
+    VoxelMap();
     ~VoxelMap() override;
 
+    // Loads the chunks around position (render space, like the camera) and evicts the far ones.
+    // Chunks are generated and meshed on the streamer's threads, this only uploads a few per call.
+    // Edited chunks are kept in memory when they are evicted and loaded back from there.
+    void stream_around(Vector3 position);
+    bool is_streaming() const { return streamer != nullptr; }
+    StreamStats get_stream_stats() const;
+    ModelMemoryStats get_model_stats() const;
+
     VoxelID* get_voxel(Int3 pos) override;
+    // Changes a voxel, updates its chunk's summary and marks the chunk for remeshing.
+    // Returns false if pos is outside the map.
+    bool set_voxel(Int3 pos, VoxelID id);
     Int2 get_size() override;
     void update_models() override;
     std::vector<ModelInfo*> get_models() override;
+    // Walks chunk by chunk, skipping empty chunks and the air above each chunk's terrain
+    bool raycast(const Ray& ray, float max_distance, VoxelHit& hit) override;
 
     Int2 get_chunk_count() const;
     VoxelChunk* get_chunk(Int2 pos);
+    // Position of a chunk's origin in the grid, in render space (before the grid's transform)
+    Vector3 get_chunk_offset(Int2 chunk_pos) const;
+    // Centre of a voxel, in render space (before global::voxel_scale)
+    Vector3 get_voxel_position(Int3 pos) const;
+
+    // nullptr if there is no such chunk
+    const ChunkSummary* get_chunk_summary(Int2 chunk_pos) const;
+    // Highest solid voxel + 1 of the column at map position (x, y), 0 if it is empty
+    int get_surface_height(Int2 column) const;
 
     static VoxelID* get_chunk_voxel(VoxelChunk& chunk, Int3 pos);
+    // The terrain of a chunk, only columns below limit are filled in. Safe to call from any thread.
+    static void generate_chunk(VoxelChunk& chunk, Int2 chunk_pos, Int2 limit = {INT32_MAX, INT32_MAX});
 
 private:
     Int2 size;
     Int2 chunk_count;
+    // Loaded chunks are inside [chunk_min, chunk_max)
+    Int2 chunk_min{}, chunk_max{};
+
+    // streaming only
+    std::unique_ptr<ChunkStreamer> streamer;
+    std::set<Int2> pending_chunks;
+    std::set<Int2> edited_chunks;
+    std::map<Int2, VoxelChunk> saved_chunks;
+    std::vector<Int2> stream_offsets; // every chunk offset within stream_radius, closest first
+    int stream_offsets_radius = -1;
+    StreamStats stream_stats;
+    ModelMemoryStats model_stats;
+    std::set<Int2> evicted_chunks;
+    // scratch for update_models(): (out of view, distance to the camera, chunk)
+    std::vector<std::tuple<bool, float, Int2>> remesh_queue;
+    // What track_chunk_memory() last reported to global::memory_tracker
+    size_t tracked_voxel_bytes = 0, tracked_summary_bytes = 0;
+
+    // Frees the model's meshes (if it still has them) and takes them off model_bytes
+    void unload_chunk_model(ModelInfo& model_info);
+    void enforce_model_budget();
+    // Reports the voxels and summaries held (loaded and saved chunks) to global::memory_tracker
+    void track_chunk_memory(bool release = false);
+
+    void set_colours();
+    void update_chunk_bounds();
+    void evict_chunk(Int2 chunk_pos);
 };
 
 
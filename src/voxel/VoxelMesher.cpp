@@ -4,7 +4,10 @@
 
 #include "voxel/VoxelMesher.hpp"
 #include <raylib.h>
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 #include <cstring> // memcpy
@@ -13,16 +16,47 @@
 #include "game/main.hpp"
 
 
-// Helper: linear index for (x,y,z_map) in chunk
-inline int idx(int x, int y, int z) {
-    return x + y * CHUNK_SIZE + z * CHUNK_SIZE * CHUNK_SIZE;
+// Neighbor directions in MAP space (x,y,z), and their normals in WORLD space
+struct Dir { int dx, dy, dz; Vector3 nWorld; };
+static constexpr Dir DIRS[6] = {
+    { +1,  0,  0, { +1,  0,  0 } }, // +X
+    { -1,  0,  0, { -1,  0,  0 } }, // -X
+    {  0, +1,  0, {  0,  0, +1 } }, // +Y map -> +Z world
+    {  0, -1,  0, {  0,  0, -1 } }, // -Y map -> -Z world
+    {  0,  0, +1, {  0, +1,  0 } }, // +Z map (up) -> +Y world
+    {  0,  0, -1, {  0, -1,  0 } }, // -Z map (down) -> -Y world
+};
+
+// Four CCW corners per face in MAP space (relative to voxel min corner)
+static constexpr Vector3 FACE_CORNERS_MAP[6][4] = {
+    { {1,0,0}, {1,0,1}, {1,1,1}, {1,1,0} }, // +X
+    { {0,0,0}, {0,1,0}, {0,1,1}, {0,0,1} }, // -X
+    { {0,1,0}, {1,1,0}, {1,1,1}, {0,1,1} }, // +Y (map)
+    { {0,0,0}, {0,0,1}, {1,0,1}, {1,0,0} }, // -Y (map)
+    { {0,0,1}, {0,1,1}, {1,1,1}, {1,0,1} }, // +Z (up)
+    { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} }, // -Z (down)
+};
+
+static constexpr float FACE_UV[8] = { 0,0,  1,0,  1,1,  0,1 };
+
+// |corner 1 - corner 0| and |corner 3 - corner 0| of every face, the axes FACE_UV goes along
+static constexpr Vector3 getFaceAxis(const int f, const int corner) {
+    const Vector3 a = FACE_CORNERS_MAP[f][0], b = FACE_CORNERS_MAP[f][corner];
+    return Vector3{a.x != b.x ? 1.0f : 0.0f, a.y != b.y ? 1.0f : 0.0f, a.z != b.z ? 1.0f : 0.0f};
 }
+static constexpr Vector3 FACE_U_AXIS[6] = {
+    getFaceAxis(0, 1), getFaceAxis(1, 1), getFaceAxis(2, 1), getFaceAxis(3, 1), getFaceAxis(4, 1), getFaceAxis(5, 1),
+};
+static constexpr Vector3 FACE_V_AXIS[6] = {
+    getFaceAxis(0, 3), getFaceAxis(1, 3), getFaceAxis(2, 3), getFaceAxis(3, 3), getFaceAxis(4, 3), getFaceAxis(5, 3),
+};
 
-// Helper: is inside current chunk
-inline bool inChunk(int x, int y, int z) {
-    return (0 <= x && x < CHUNK_SIZE) &&
-           (0 <= y && y < CHUNK_SIZE) &&
-           (0 <= z && z < CHUNK_SIZE);
+// Offset of the neighbor in DIRS[f] in a chunk of N^3
+template<int N>
+static constexpr std::array<int, 6> getNeighborOffsets() {
+    std::array<int, 6> offsets{};
+    for (int f = 0; f < 6; ++f) offsets[f] = ChunkLayout<N>::index(DIRS[f].dx, DIRS[f].dy, DIRS[f].dz);
+    return offsets;
 }
 
 struct Accum {
@@ -32,141 +66,272 @@ struct Accum {
     std::vector<unsigned short> indices; // 3 per triangle
 };
 
-std::vector<MaterialMesh>
-build_chunk_mesh(const VoxelChunk& chunk, Vector3 origin, float voxelSize) {
-    //TODO (optimisation)
-    // the chunk mesher could be massively improved if it was switched to a greedy algorithm
-
-    // Neighbor directions in MAP space (x,y,z), and their normals in WORLD space
-    struct Dir { int dx, dy, dz; Vector3 nWorld; };
-    const Dir dirs[6] = {
-        { +1,  0,  0, { +1,  0,  0 } }, // +X
-        { -1,  0,  0, { -1,  0,  0 } }, // -X
-        {  0, +1,  0, {  0,  0, +1 } }, // +Y map -> +Z world
-        {  0, -1,  0, {  0,  0, -1 } }, // -Y map -> -Z world
-        {  0,  0, +1, {  0, +1,  0 } }, // +Z map (up) -> +Y world
-        {  0,  0, -1, {  0, -1,  0 } }, // -Z map (down) -> -Y world
-    };
+// One quad of voxel faces in direction f, covering size voxels from base (both in MAP space)
+static void emitQuad(Accum& A, const Vector3 origin, const float voxelSize, const Vector3 base, const Vector3 size, const int f) {
+    const size_t baseIndex = A.vertices.size() / 3;
+    A.vertices.resize(A.vertices.size() + 4 * 3);
+    A.normals.resize(A.normals.size() + 4 * 3);
+    A.uvs.resize(A.uvs.size() + 4 * 2);
+    float* vertex = &A.vertices[baseIndex * 3];
+    float* normal = &A.normals[baseIndex * 3];
+    float* uv = &A.uvs[baseIndex * 2];
+
+    // one 0..1 tile per voxel, along the edges 0->1 and 0->3 of the face
+    const float uScale = FACE_U_AXIS[f].x * size.x + FACE_U_AXIS[f].y * size.y + FACE_U_AXIS[f].z * size.z;
+    const float vScale = FACE_V_AXIS[f].x * size.x + FACE_V_AXIS[f].y * size.y + FACE_V_AXIS[f].z * size.z;
+
+    for (int i = 0; i < 4; ++i) {
+        const Vector3 cm = FACE_CORNERS_MAP[f][i];
+        const float mx = base.x + cm.x * size.x;
+        const float my = base.y + cm.y * size.y;
+        const float mz = base.z + cm.z * size.z;
+
+        // Map (x,y,z_map) -> World (X=x, Y=z_map, Z=y)
+        vertex[i*3 + 0] = origin.x + mx * voxelSize;
+        vertex[i*3 + 1] = origin.y + mz * voxelSize; // up
+        vertex[i*3 + 2] = origin.z + my * voxelSize;
+
+        normal[i*3 + 0] = DIRS[f].nWorld.x;
+        normal[i*3 + 1] = DIRS[f].nWorld.y;
+        normal[i*3 + 2] = DIRS[f].nWorld.z;
+
+        uv[i*2 + 0] = FACE_UV[i*2 + 0] * uScale;
+        uv[i*2 + 1] = FACE_UV[i*2 + 1] * vScale;
+    }
 
-    // Four CCW corners per face in MAP space (relative to voxel min corner)
-    const std::array<std::array<Vector3,4>, 6> faceCornersMap = {
-        // +X
-        std::array<Vector3,4>{ Vector3{1,0,0}, Vector3{1,0,1}, Vector3{1,1,1}, Vector3{1,1,0} },
-        // -X
-        std::array<Vector3,4>{ Vector3{0,0,0}, Vector3{0,1,0}, Vector3{0,1,1}, Vector3{0,0,1} },
-        // +Y (map)
-        std::array<Vector3,4>{ Vector3{0,1,0}, Vector3{1,1,0}, Vector3{1,1,1}, Vector3{0,1,1} },
-        // -Y (map)
-        std::array<Vector3,4>{ Vector3{0,0,0}, Vector3{0,0,1}, Vector3{1,0,1}, Vector3{1,0,0} },
-        // +Z (up)
-        std::array<Vector3,4>{ Vector3{0,0,1}, Vector3{0,1,1}, Vector3{1,1,1}, Vector3{1,0,1} },
-        // -Z (down)
-        std::array<Vector3,4>{ Vector3{0,0,0}, Vector3{1,0,0}, Vector3{1,1,0}, Vector3{0,1,0} }
-    };
+    // Two triangles (0,1,2) and (0,2,3)
+    static constexpr unsigned short QUAD[6] = { 0, 1, 2, 0, 2, 3 };
+    for (const unsigned short i : QUAD) A.indices.push_back(static_cast<unsigned short>(baseIndex + i));
+}
 
-    const float faceUV[8] = { 0,0,  1,0,  1,1,  0,1 };
+// A's current mesh, moved to done first if another quad would not fit in it
+static Accum& getRoomFor(Accum& A, const VoxelID id, std::vector<std::pair<VoxelID, Accum>>& done) {
+    if (A.vertices.size() / 3 + 4 > MESH_MAX_VERTICES) {
+        done.emplace_back(id, std::move(A));
+        A = Accum{};
+    }
+    return A;
+}
 
-    // Accumulate per material id
-    std::unordered_map<VoxelID, Accum> byMat;
-    byMat.reserve(8);
+// What the accumulators have reserved, for the mesher scratch in the memory stats
+static size_t getScratchBytes(const std::vector<std::pair<VoxelID, Accum>>& done) {
+    size_t bytes = 0;
+    for (const auto& [id, A] : done) {
+        bytes += (A.vertices.capacity() + A.normals.capacity() + A.uvs.capacity()) * sizeof(float);
+        bytes += A.indices.capacity() * sizeof(unsigned short);
+    }
+    return bytes;
+}
 
-    auto emitFace = [&](Accum& A, int x, int y, int z, int f) {
-        const float bx = static_cast<float>(x);
-        const float by = static_cast<float>(y);
-        const float bz = static_cast<float>(z);
+// Convert accumulators to meshes, not uploaded yet
+static std::vector<MaterialMesh> toMeshes(std::vector<std::pair<VoxelID, Accum>>& done) {
+    std::vector<MaterialMesh> result;
+    result.reserve(done.size());
+    for (auto& [id, A] : done) {
+        if (A.indices.empty()) continue;
+        Mesh mesh = {0};
+        mesh.vertexCount   = static_cast<int>(A.vertices.size() / 3);
+        mesh.triangleCount = static_cast<int>(A.indices.size() / 3);
+
+        mesh.vertices = (float*)MemAlloc(A.vertices.size() * sizeof(float));
+        std::memcpy(mesh.vertices, A.vertices.data(), A.vertices.size() * sizeof(float));
+        mesh.normals = (float*)MemAlloc(A.normals.size() * sizeof(float));
+        std::memcpy(mesh.normals, A.normals.data(), A.normals.size() * sizeof(float));
+        mesh.texcoords = (float*)MemAlloc(A.uvs.size() * sizeof(float));
+        std::memcpy(mesh.texcoords, A.uvs.data(), A.uvs.size() * sizeof(float));
+        mesh.indices = (unsigned short*)MemAlloc(A.indices.size() * sizeof(unsigned short));
+        std::memcpy(mesh.indices, A.indices.data(), A.indices.size() * sizeof(unsigned short));
+        global::memory_tracker.allocate(MemoryTag::MeshData, get_mesh_bytes(mesh));
 
-        const size_t baseIndex = A.vertices.size() / 3;
+        result.push_back(MaterialMesh{ id, mesh });
+    }
+    return result;
+}
 
-        for (int i = 0; i < 4; ++i) {
-            const Vector3 cm = faceCornersMap[f][i];
-            const float mx = bx + cm.x;
-            const float my = by + cm.y;
-            const float mz = bz + cm.z;
+std::vector<MaterialMesh>
+build_chunk_mesh(const VoxelChunk& chunk, Vector3 origin, float voxelSize, int height) {
+    auto meshes = build_chunk_mesh_data(chunk, origin, voxelSize, height);
+    upload_chunk_mesh(meshes);
+    return meshes;
+}
 
-            // Map (x,y,z_map) -> World (X=x, Y=z_map, Z=y)
-            const float wx = origin.x + mx * voxelSize;
-            const float wy = origin.y + mz * voxelSize; // up
-            const float wz = origin.z + my * voxelSize;
+void upload_chunk_mesh(std::vector<MaterialMesh>& meshes) {
+    for (MaterialMesh& mat : meshes) {
+        global::render_backend->upload_mesh(mat.mesh, false); // static by default
+        global::memory_tracker.allocate(MemoryTag::GpuMeshes, get_mesh_bytes(mat.mesh));
+    }
+}
 
-            A.vertices.push_back(wx);
-            A.vertices.push_back(wy);
-            A.vertices.push_back(wz);
+void unload_chunk_mesh(std::vector<MaterialMesh>& meshes) {
+    for (MaterialMesh& mat : meshes) {
+        global::memory_tracker.free(MemoryTag::MeshData, get_mesh_bytes(mat.mesh));
+        global::render_backend->unload_mesh(mat.mesh);
+    }
+    meshes.clear();
+}
 
-            A.normals.push_back(dirs[f].nWorld.x);
-            A.normals.push_back(dirs[f].nWorld.y);
-            A.normals.push_back(dirs[f].nWorld.z);
+void unload_voxel_model(Model& model) {
+    const size_t bytes = get_model_bytes(model);
+    global::memory_tracker.free(MemoryTag::MeshData, bytes);
+    global::memory_tracker.free(MemoryTag::GpuMeshes, bytes);
+    global::render_backend->unload_model(model);
+    model = Model{};
+}
 
-            A.uvs.push_back(faceUV[i*2 + 0]);
-            A.uvs.push_back(faceUV[i*2 + 1]);
-        }
+template<int N>
+static std::vector<MaterialMesh>
+meshNaive(const BasicVoxelChunk<N>& chunk, Vector3 origin, float voxelSize, int height) {
+    using Layout = ChunkLayout<N>;
+    static constexpr std::array<int, 6> neighbor = getNeighborOffsets<N>();
 
-        // Two triangles (0,1,2) and (0,2,3)
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 0));
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 1));
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 2));
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 0));
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 2));
-        A.indices.push_back(static_cast<unsigned short>(baseIndex + 3));
-    };
+    // Accumulate per material id, full ones (MESH_MAX_VERTICES) are moved to done
+    std::unordered_map<VoxelID, Accum> byMat;
+    byMat.reserve(8);
+    std::vector<std::pair<VoxelID, Accum>> done;
 
     // Walk voxels: add faces only when neighbor is AIR (0)
-    for (int z = 0; z < CHUNK_SIZE; ++z) {
-        for (int y = 0; y < CHUNK_SIZE; ++y) {
-            for (int x = 0; x < CHUNK_SIZE; ++x) {
-                VoxelID v = chunk[idx(x,y,z)];
+    for (int z = 0; z < height; ++z) {
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                const int i = Layout::index(x, y, z);
+                VoxelID v = chunk[i];
                 if (v == 0) continue; // air
 
                 for (int f = 0; f < 6; ++f) {
-                    const int nx = x + dirs[f].dx;
-                    const int ny = y + dirs[f].dy;
-                    const int nz = z + dirs[f].dz;
+                    // Treat OOB as air; stitch with neighbor chunks later if desired
+                    const bool inside = Layout::contains(x + DIRS[f].dx, y + DIRS[f].dy, z + DIRS[f].dz);
+                    if (inside && chunk[i + neighbor[f]] != 0) continue;
 
-                    bool neighborSolid = false;
-                    if (inChunk(nx, ny, nz)) {
-                        neighborSolid = (chunk[idx(nx,ny,nz)] != 0);
-                    } else {
-                        // Treat OOB as air; stitch with neighbor chunks later if desired
-                        neighborSolid = false;
-                    }
-                    if (!neighborSolid) {
-                        Accum& A = byMat[v];
-                        emitFace(A, x, y, z, f);
-                    }
+                    const Vector3 base = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+                    emitQuad(getRoomFor(byMat[v], v, done), origin, voxelSize, base, Vector3{1, 1, 1}, f);
                 }
             }
         }
     }
+    for (auto& [id, A] : byMat) done.emplace_back(id, std::move(A));
 
-    // Convert accumulators to GPU meshes
-    std::vector<MaterialMesh> result;
-    result.reserve(byMat.size());
-    for (auto& [id, A] : byMat) {
-        Mesh mesh = {0};
-        mesh.vertexCount   = static_cast<int>(A.vertices.size() / 3);
-        mesh.triangleCount = static_cast<int>(A.indices.size() / 3);
+    // freed once the meshes are copied out of done
+    ScopedAllocation scratch(global::memory_tracker, MemoryTag::MesherScratch);
+    scratch.add(getScratchBytes(done));
+    return toMeshes(done);
+}
 
-        if (!A.vertices.empty()) {
-            mesh.vertices = (float*)MemAlloc(A.vertices.size() * sizeof(float));
-            std::memcpy(mesh.vertices, A.vertices.data(), A.vertices.size() * sizeof(float));
-        }
-        if (!A.normals.empty()) {
-            mesh.normals = (float*)MemAlloc(A.normals.size() * sizeof(float));
-            std::memcpy(mesh.normals, A.normals.data(), A.normals.size() * sizeof(float));
-        }
-        if (!A.uvs.empty()) {
-            mesh.texcoords = (float*)MemAlloc(A.uvs.size() * sizeof(float));
-            std::memcpy(mesh.texcoords, A.uvs.data(), A.uvs.size() * sizeof(float));
+template<int N>
+static std::vector<MaterialMesh>
+meshBinary(const BasicVoxelChunk<N>& chunk, Vector3 origin, float voxelSize, int height, bool greedy) {
+    static_assert(N <= 64, "a row of voxels has to fit in a uint64_t");
+    using Layout = ChunkLayout<N>;
+    using Mask = std::conditional_t<N <= 32, uint32_t, uint64_t>;
+
+    // Bit x of rows_x[y + z * N] is voxel (x, y, z), bit y of rows_y[x + z * N] is the same voxel.
+    // One of these for all the solid voxels, and one for each material.
+    struct Occupancy {
+        VoxelID id;
+        std::vector<Mask> rows_x, rows_y;
+    };
+    // Layer height is only read as the neighbor of the faces below it
+    const int depth = std::min(height + 1, N);
+    auto makeOccupancy = [&](const VoxelID id) {
+        return Occupancy{id, std::vector<Mask>(N * depth, 0), std::vector<Mask>(N * depth, 0)};
+    };
+
+    Occupancy solid = makeOccupancy(0);
+    std::vector<Occupancy> materials;
+    std::array<int, 256> slots;
+    slots.fill(-1);
+    for (int z = 0; z < depth; ++z) {
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                const VoxelID v = chunk[Layout::index(x, y, z)];
+                if (v == 0) continue;
+                if (slots[v] < 0) {
+                    slots[v] = static_cast<int>(materials.size());
+                    materials.emplace_back(makeOccupancy(v));
+                }
+                Occupancy& mat = materials[slots[v]];
+                const Mask bit_x = Mask(1) << x, bit_y = Mask(1) << y;
+                solid.rows_x[y + z * N] |= bit_x;
+                solid.rows_y[x + z * N] |= bit_y;
+                mat.rows_x[y + z * N] |= bit_x;
+                mat.rows_y[x + z * N] |= bit_y;
+            }
         }
-        if (!A.indices.empty()) {
-            mesh.indices = (unsigned short*)MemAlloc(A.indices.size() * sizeof(unsigned short));
-            std::memcpy(mesh.indices, A.indices.data(), A.indices.size() * sizeof(unsigned short));
+    }
+    // Meshes come out in order of material id
+    std::sort(materials.begin(), materials.end(), [](const Occupancy& a, const Occupancy& b) { return a.id < b.id; });
+    ScopedAllocation scratch(global::memory_tracker, MemoryTag::MesherScratch);
+    scratch.add((materials.size() + 1) * 2 * N * depth * sizeof(Mask));
+
+    std::vector<std::pair<VoxelID, Accum>> done;
+    std::array<Mask, N> plane;
+    for (const Occupancy& mat : materials) {
+        Accum A;
+        for (int f = 0; f < 6; ++f) {
+            // Slices of the chunk across the face normal. Every slice is a plane of rows (v) of bits (u):
+            //   +-X: slice x, rows z, bits y    +-Y: slice y, rows z, bits x    +-Z: slice z, rows y, bits x
+            const bool along_x = f < 2, along_z = f >= 4;
+            const int step = (f % 2 == 0) ? 1 : -1;
+            const int slices = along_z ? height : N;
+            const int rows = along_z ? N : height;
+
+            for (int s = 0; s < slices; ++s) {
+                // Faces of the material in the slice, minus the ones covered by the neighbor slice
+                const int n = s + step;
+                const bool has_neighbor = 0 <= n && n < (along_z ? depth : N);
+                Mask any = 0;
+                for (int r = 0; r < rows; ++r) {
+                    Mask faces, covered = 0;
+                    if (along_x) {
+                        faces = mat.rows_y[s + r * N];
+                        if (has_neighbor) covered = solid.rows_y[n + r * N];
+                    } else if (along_z) {
+                        faces = mat.rows_x[r + s * N];
+                        if (has_neighbor) covered = solid.rows_x[r + n * N];
+                    } else {
+                        faces = mat.rows_x[s + r * N];
+                        if (has_neighbor) covered = solid.rows_x[n + r * N];
+                    }
+                    plane[r] = faces & ~covered;
+                    any |= plane[r];
+                }
+                if (any == 0) continue;
+
+                for (int r = 0; r < rows; ++r) {
+                    while (plane[r] != 0) {
+                        // Widest run of faces from the lowest one, then as many rows up as have all of it
+                        const int u = std::countr_zero(plane[r]);
+                        const int w = greedy ? std::countr_one(static_cast<Mask>(plane[r] >> u)) : 1;
+                        const Mask run = (w >= std::numeric_limits<Mask>::digits ? ~Mask(0) : (Mask(1) << w) - 1) << u;
+                        int h = 1;
+                        while (greedy && r + h < rows && (plane[r + h] & run) == run) {
+                            plane[r + h] &= ~run;
+                            h++;
+                        }
+                        plane[r] &= ~run;
+
+                        const float fs = static_cast<float>(s), fu = static_cast<float>(u), fr = static_cast<float>(r);
+                        const float fw = static_cast<float>(w), fh = static_cast<float>(h);
+                        Vector3 base, size;
+                        if (along_x)      { base = {fs, fu, fr}; size = {1, fw, fh}; }
+                        else if (along_z) { base = {fu, fr, fs}; size = {fw, fh, 1}; }
+                        else              { base = {fu, fs, fr}; size = {fw, 1, fh}; }
+                        emitQuad(getRoomFor(A, mat.id, done), origin, voxelSize, base, size, f);
+                    }
+                }
+            }
         }
-
-        UploadMesh(&mesh, false); // static by default
-        result.push_back(MaterialMesh{ id, mesh });
+        done.emplace_back(mat.id, std::move(A));
     }
 
-    return result;
+    scratch.add(getScratchBytes(done));
+    return toMeshes(done);
+}
+
+template<int N>
+std::vector<MaterialMesh>
+build_chunk_mesh_data(const BasicVoxelChunk<N>& chunk, Vector3 origin, float voxelSize, int height, ChunkMesher mesher) {
+    if (mesher == ChunkMesher::Naive) return meshNaive<N>(chunk, origin, voxelSize, height);
+    return meshBinary<N>(chunk, origin, voxelSize, height, mesher == ChunkMesher::Greedy);
 }
 
 Model build_chunk_model(const std::vector<MaterialMesh> &mats, const std::map<VoxelID, Color> &voxelColourMap) {
@@ -187,7 +352,7 @@ Model build_chunk_model(const std::vector<MaterialMesh> &mats, const std::map<Vo
     model.materialCount = n;
     model.materials = (Material*)MemAlloc(sizeof(Material) * n);
     for (int i = 0; i < n; ++i) {
-        model.materials[i] = LoadMaterialDefault();
+        model.materials[i] = global::render_backend->load_material_default();
         Color c = PURPLE;
         if (auto it = voxelColourMap.find(mats[i].id); it != voxelColourMap.end())
             c = it->second;
@@ -202,3 +367,72 @@ Model build_chunk_model(const std::vector<MaterialMesh> &mats, const std::map<Vo
 
     return model;
 }
+
+template<int N>
+std::vector<BoundingBox> build_chunk_occluders(const BasicVoxelChunk<N>& chunk) {
+    static_assert(N % OCCLUDER_CELL == 0);
+    std::vector<BoundingBox> out;
+    for (int cy = 0; cy < N; cy += OCCLUDER_CELL) {
+        for (int cx = 0; cx < N; cx += OCCLUDER_CELL) {
+            // lowest solid run from the bottom among the cell's columns
+            int height = N;
+            for (int y = cy; y < cy + OCCLUDER_CELL && height > 0; ++y) {
+                for (int x = cx; x < cx + OCCLUDER_CELL && height > 0; ++x) {
+                    int z = 0;
+                    while (z < height && chunk[ChunkLayout<N>::index(x,y,z)] != 0) ++z;
+                    height = z;
+                }
+            }
+            if (height == 0) continue;
+
+            // Map (x,y,z_map) -> World (X=x, Y=z_map, Z=y)
+            out.emplace_back(BoundingBox{
+                Vector3{static_cast<float>(cx), 0.0f, static_cast<float>(cy)},
+                Vector3{static_cast<float>(cx + OCCLUDER_CELL), static_cast<float>(height), static_cast<float>(cy + OCCLUDER_CELL)},
+            });
+        }
+    }
+    return out;
+}
+
+#define INSTANTIATE_CHUNK_MESHER(N) \
+    template std::vector<MaterialMesh> build_chunk_mesh_data<N>(const BasicVoxelChunk<N>&, Vector3, float, int, ChunkMesher); \
+    template std::vector<BoundingBox> build_chunk_occluders<N>(const BasicVoxelChunk<N>&);
+
+INSTANTIATE_CHUNK_MESHER(16)
+INSTANTIATE_CHUNK_MESHER(32)
+INSTANTIATE_CHUNK_MESHER(64)
+#if CHUNK_SIZE != 16 && CHUNK_SIZE != 32 && CHUNK_SIZE != 64
+INSTANTIATE_CHUNK_MESHER(CHUNK_SIZE)
+#endif
+
+BoundingBox get_model_bounds(const Model &model) {
+    if (model.meshCount == 0) return BoundingBox{};
+
+    BoundingBox bounds = GetMeshBoundingBox(model.meshes[0]);
+    for (int i = 1; i < model.meshCount; ++i) {
+        BoundingBox mesh_bounds = GetMeshBoundingBox(model.meshes[i]);
+        bounds.min = Vector3Min(bounds.min, mesh_bounds.min);
+        bounds.max = Vector3Max(bounds.max, mesh_bounds.max);
+    }
+    return bounds;
+}
+
+size_t get_mesh_bytes(const Mesh& mesh) {
+    const auto vertices = static_cast<size_t>(mesh.vertexCount);
+    size_t bytes = 0;
+    if (mesh.vertices) bytes += vertices * 3 * sizeof(float);
+    if (mesh.normals) bytes += vertices * 3 * sizeof(float);
+    if (mesh.texcoords) bytes += vertices * 2 * sizeof(float);
+    if (mesh.texcoords2) bytes += vertices * 2 * sizeof(float);
+    if (mesh.tangents) bytes += vertices * 4 * sizeof(float);
+    if (mesh.colors) bytes += vertices * 4 * sizeof(unsigned char);
+    if (mesh.indices) bytes += static_cast<size_t>(mesh.triangleCount) * 3 * sizeof(unsigned short);
+    return bytes;
+}
+
+size_t get_model_bytes(const Model& model) {
+    size_t bytes = 0;
+    for (int i = 0; i < model.meshCount; i++) bytes += get_mesh_bytes(model.meshes[i]);
+    return bytes;
+}
@@ -6,13 +6,60 @@
 #define BUSINESS_GAME_VOXELMESHER_HPP
 #include "VoxelMap.hpp"
 
+// Side of the column cells used by build_chunk_occluders()
+#define OCCLUDER_CELL 4
+// Mesh indices are unsigned short
+#define MESH_MAX_VERTICES 65536
+
+enum class ChunkMesher {
+    Naive,  // one quad per visible voxel face, looks at the 6 neighbors of every voxel
+    Binary, // the same quads, found a whole row at a time from bitmasks of the voxels
+    Greedy, // Binary, with the faces of a material merged into rectangles where they can be
+};
+#define DEFAULT_CHUNK_MESHER ChunkMesher::Greedy
+
 struct MaterialMesh {
     VoxelID id;
     Mesh mesh;
 };
 
-std::vector<MaterialMesh> build_chunk_mesh(const VoxelChunk& chunk, Vector3 origin, float voxelSize);
+// Only the layers below height are looked at (see ChunkSummary::height)
+std::vector<MaterialMesh> build_chunk_mesh(const VoxelChunk& chunk, Vector3 origin, float voxelSize, int height = CHUNK_SIZE);
+// The two halves of build_chunk_mesh(). The meshes from build_chunk_mesh_data() are only in
+// CPU memory, so it can run on any thread; upload_chunk_mesh() has to run on the main thread.
+// A material can end up split over several meshes, none has more than MESH_MAX_VERTICES.
+// Every mesher covers exactly the same voxel faces, `--bench chunks` checks that they do.
+template<int N>
+std::vector<MaterialMesh> build_chunk_mesh_data(const BasicVoxelChunk<N>& chunk, Vector3 origin, float voxelSize,
+                                                int height = N, ChunkMesher mesher = DEFAULT_CHUNK_MESHER);
+inline std::vector<MaterialMesh> build_chunk_mesh_data(const VoxelChunk& chunk, Vector3 origin, float voxelSize, int height = CHUNK_SIZE) {
+    return build_chunk_mesh_data<CHUNK_SIZE>(chunk, origin, voxelSize, height);
+}
+void upload_chunk_mesh(std::vector<MaterialMesh>& meshes);
+// Frees meshes from build_chunk_mesh_data() that were never uploaded
+void unload_chunk_mesh(std::vector<MaterialMesh>& meshes);
+// Frees a model from build_chunk_model() and its uploaded meshes, with both taken off the memory stats
+void unload_voxel_model(Model& model);
 
 Model build_chunk_model(const std::vector<MaterialMesh>& mats, const std::map<VoxelID, Color>& voxelColourMap);
 
+// Solid boxes inside the chunk, in the same space as build_chunk_mesh() with origin 0 and voxelSize 1.
+// The chunk is split into OCCLUDER_CELL x OCCLUDER_CELL columns, every cell gets the box
+// from the bottom up to its lowest column (only counting solid voxels from z = 0 up).
+// Used as occluders by OcclusionCuller, so they must never stick out of the terrain.
+template<int N>
+std::vector<BoundingBox> build_chunk_occluders(const BasicVoxelChunk<N>& chunk);
+inline std::vector<BoundingBox> build_chunk_occluders(const VoxelChunk& chunk) {
+    return build_chunk_occluders<CHUNK_SIZE>(chunk);
+}
+// The templates above are instantiated in VoxelMesher.cpp for chunks of 16, 32, 64 and CHUNK_SIZE
+
+// Bounds of all the meshes of the model, in model space (empty box if the model has no meshes)
+BoundingBox get_model_bounds(const Model& model);
+
+// Size of the vertex and index buffers of the model's meshes, once on the GPU.
+// raylib keeps a CPU copy of each of them too, so RAM use is about the same again.
+size_t get_mesh_bytes(const Mesh& mesh);
+size_t get_model_bytes(const Model& model);
+
 #endif //BUSINESS_GAME_VOXELMESHER_HPP
@@ -0,0 +1,119 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#include "voxel/VoxelRaycast.hpp"
+
+#include <cmath>
+#include <raymath.h>
+
+#define DDA_FACE_EPSILON 1e-3f // in voxels, closer than this to a face counts as on it
+
+bool clip_ray_to_box(const Ray& ray, const Vector3 min, const Vector3 max, float& t_enter, float& t_exit, int& axis) {
+    const float o[3] = {ray.position.x, ray.position.y, ray.position.z};
+    const float d[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+    const float lo[3] = {min.x, min.y, min.z};
+    const float hi[3] = {max.x, max.y, max.z};
+
+    t_enter = 0.0f;
+    t_exit = INFINITY;
+    axis = -1;
+    for (int i = 0; i < 3; i++) {
+        if (d[i] == 0.0f) {
+            if (o[i] < lo[i] || o[i] > hi[i]) return false;
+            continue;
+        }
+        float t0 = (lo[i] - o[i]) / d[i];
+        float t1 = (hi[i] - o[i]) / d[i];
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > t_enter) {
+            t_enter = t0;
+            axis = i;
+        }
+        t_exit = std::min(t_exit, t1);
+    }
+    return t_enter <= t_exit;
+}
+
+VoxelDDA::VoxelDDA(const Ray& ray, const float t, const int axis) : t(t), axis(axis) {
+    const float o[3] = {ray.position.x, ray.position.y, ray.position.z};
+    const float d[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+
+    for (int i = 0; i < 3; i++) {
+        const float p = o[i] + d[i] * t;
+        step[i] = (d[i] > 0.0f) ? 1 : (d[i] < 0.0f ? -1 : 0);
+        const int face = static_cast<int>(std::lround(p));
+        if (i == axis || (step[i] != 0 && std::fabs(p - static_cast<float>(face)) < DDA_FACE_EPSILON)) {
+            // on a face, the direction picks the side. Also for the other axes when the ray
+            // starts on an edge or corner, otherwise rounding can put it back in the cell it left
+            cell[i] = (step[i] > 0) ? face : face - 1;
+        } else {
+            cell[i] = static_cast<int>(std::floor(p));
+        }
+
+        if (step[i] == 0) {
+            t_max[i] = INFINITY;
+            t_delta[i] = INFINITY;
+        } else {
+            const float boundary = static_cast<float>(step[i] > 0 ? cell[i] + 1 : cell[i]);
+            t_max[i] = (boundary - o[i]) / d[i];
+            t_delta[i] = 1.0f / std::fabs(d[i]);
+        }
+    }
+}
+
+void VoxelDDA::next() {
+    int a = 0;
+    if (t_max[1] < t_max[a]) a = 1;
+    if (t_max[2] < t_max[a]) a = 2;
+    cell[a] += step[a];
+    t = t_max[a];
+    t_max[a] += t_delta[a];
+    axis = a;
+}
+
+Int3 VoxelDDA::get_cell() const {
+    return Int3{cell[0], cell[1], cell[2]};
+}
+
+Int3 VoxelDDA::get_normal() const {
+    int n[3] = {0, 0, 0};
+    if (axis >= 0) n[axis] = -step[axis];
+    return Int3{n[0], n[1], n[2]};
+}
+
+// World (render space) -> grid space, the inverse of the grid's world matrix
+static Ray toGridSpace(const Ray& ray, const Matrix& world_matrix) {
+    const Matrix inverse = MatrixInvert(world_matrix);
+    const Vector3 o = Vector3Transform(ray.position, inverse);
+    const Vector3 d = Vector3Subtract(Vector3Transform(Vector3Add(ray.position, ray.direction), inverse), o);
+
+    // Render (X, Y up, Z) -> Map (x=X, y=Z, z=Y)
+    // the direction is not normalized again, so t stays the same in both spaces
+    return Ray{Vector3{o.x, o.z, o.y}, Vector3{d.x, d.z, d.y}};
+}
+
+std::optional<VoxelHit> raycast_voxel_grids(const std::vector<VoxelGrid*>& grids, const Ray& ray,
+    const float max_distance) {
+    std::optional<VoxelHit> nearest;
+    float distance = max_distance;
+    for (VoxelGrid* grid : grids) {
+        VoxelHit hit{};
+        if (!grid->raycast(toGridSpace(ray, grid->get_world_matrix()), distance, hit)) continue;
+        hit.grid = grid;
+        hit.point = Vector3Add(ray.position, Vector3Scale(ray.direction, hit.distance));
+        distance = hit.distance;
+        nearest = hit;
+    }
+    return nearest;
+}
+
+Vector3 get_voxel_world_position(const VoxelGrid& grid, const Int3 pos) {
+    // Map (x,y,z) -> Render (X=x, Y=z, Z=y), same as the mesher
+    const Vector3 local = {
+        static_cast<float>(pos.x) + 0.5f,
+        static_cast<float>(pos.z) + 0.5f,
+        static_cast<float>(pos.y) + 0.5f,
+    };
+    return Vector3Transform(local, grid.get_world_matrix());
+}
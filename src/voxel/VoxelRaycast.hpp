@@ -0,0 +1,47 @@
+//
+// Created by Andrei Ghita on 18.10.2026.
+//
+
+#ifndef BUSINESS_GAME_VOXELRAYCAST_HPP
+#define BUSINESS_GAME_VOXELRAYCAST_HPP
+#include <raylib.h>
+#include <optional>
+#include <vector>
+#include "voxel/VoxelGrid.hpp"
+
+// Rays in GRID space use map coordinates (x, y, z up), one unit per voxel.
+// Voxel (x,y,z) is the cell [x, x+1) x [y, y+1) x [z, z+1).
+
+// Clips the ray to the box [min, max]. Returns false if it misses.
+// t_enter is 0 and axis is -1 if the ray starts inside the box,
+// otherwise axis is the axis of the face the ray enters through.
+bool clip_ray_to_box(const Ray& ray, Vector3 min, Vector3 max, float& t_enter, float& t_exit, int& axis);
+
+// Amanatides-Woo traversal of the voxels along a ray (grid space).
+// The ray direction doesn't have to be normalized, t is always in its units.
+struct VoxelDDA {
+    int cell[3]{};
+    int step[3]{};
+    float t_max[3]{};   // t at which the ray crosses into the next cell, per axis
+    float t_delta[3]{}; // t between two crossings, per axis
+    float t = 0.0f;     // t at which the ray entered cell
+    int axis = -1;      // axis of the face it entered through, -1 if it started inside
+
+    // Starts at the point ray.position + ray.direction * t, which lies on a face
+    // perpendicular to axis (or anywhere if axis is -1)
+    VoxelDDA(const Ray& ray, float t, int axis);
+
+    void next();
+    Int3 get_cell() const;
+    // Normal of the face cell was entered through
+    Int3 get_normal() const;
+};
+
+// Casts a WORLD space ray (render space, after global::voxel_scale) against every grid.
+// Returns the nearest hit within max_distance (in the ray's units).
+std::optional<VoxelHit> raycast_voxel_grids(const std::vector<VoxelGrid*>& grids, const Ray& ray, float max_distance);
+
+// World space centre of a voxel of the grid
+Vector3 get_voxel_world_position(const VoxelGrid& grid, Int3 pos);
+
+#endif //BUSINESS_GAME_VOXELRAYCAST_HPP